@@ -0,0 +1,98 @@
+// Copyright (C) James Baxter. All Rights Reserved.
+
+#include "ST_InputModifierKeySettings.h"
+#include "ST_InputTrigger_ModifierKeys.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogST_InputModifierKeySettings, Log, All);
+
+namespace
+{
+	constexpr int32 NumBuiltInModifiers = static_cast<int32>(EST_InputModifierSlot::Custom1);
+
+	const TCHAR* BuiltInModifierNames[NumBuiltInModifiers] = { TEXT("Shift"), TEXT("Ctrl"), TEXT("Alt"), TEXT("Cmd") };
+}
+
+///////////////////////
+///// Constructor /////
+///////////////////////
+
+UST_InputModifierKeySettings::UST_InputModifierKeySettings()
+	: Super()
+{
+	CategoryName = TEXT("Engine");
+}
+
+/////////////////////
+///// Lifecycle /////
+/////////////////////
+
+void UST_InputModifierKeySettings::PostInitProperties()
+{
+	Super::PostInitProperties();
+
+	RebuildModifierKeyBits();
+}
+
+void UST_InputModifierKeySettings::PostReloadConfig(FProperty* PropertyThatWasLoaded)
+{
+	Super::PostReloadConfig(PropertyThatWasLoaded);
+
+	RebuildModifierKeyBits();
+}
+
+#if WITH_EDITOR
+void UST_InputModifierKeySettings::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	RebuildModifierKeyBits();
+}
+#endif
+
+////////////////////
+///// Registry /////
+////////////////////
+
+FName UST_InputModifierKeySettings::GetModifierName(const int32 InSlot) const
+{
+	if (InSlot >= 0 && InSlot < NumBuiltInModifiers)
+	{
+		return FName(BuiltInModifierNames[InSlot]);
+	}
+
+	const int32 CustomIndex = InSlot - NumBuiltInModifiers;
+	return CustomModifiers.IsValidIndex(CustomIndex) ? CustomModifiers[CustomIndex].Name : NAME_None;
+}
+
+void UST_InputModifierKeySettings::RebuildModifierKeyBits()
+{
+	ModifierKeyBits.Reset();
+
+	// Matches UPlayerInput::IsShiftPressed() etc.
+	ModifierKeyBits.Add({ EKeys::LeftShift, FST_InputTriggerModifiers::Shift });
+	ModifierKeyBits.Add({ EKeys::RightShift, FST_InputTriggerModifiers::Shift });
+	ModifierKeyBits.Add({ EKeys::LeftControl, FST_InputTriggerModifiers::Ctrl });
+	ModifierKeyBits.Add({ EKeys::RightControl, FST_InputTriggerModifiers::Ctrl });
+	ModifierKeyBits.Add({ EKeys::LeftAlt, FST_InputTriggerModifiers::Alt });
+	ModifierKeyBits.Add({ EKeys::RightAlt, FST_InputTriggerModifiers::Alt });
+	ModifierKeyBits.Add({ EKeys::LeftCommand, FST_InputTriggerModifiers::Cmd });
+	ModifierKeyBits.Add({ EKeys::RightCommand, FST_InputTriggerModifiers::Cmd });
+
+	const int32 MaxCustomModifiers = FST_InputTriggerModifiers::MaxModifiers - NumBuiltInModifiers;
+	if (CustomModifiers.Num() > MaxCustomModifiers)
+	{
+		UE_LOG(LogST_InputModifierKeySettings, Warning, TEXT("%i Custom Modifiers registered, only the first %i will be used"), CustomModifiers.Num(), MaxCustomModifiers);
+	}
+
+	for (int32 CustomIdx = 0; CustomIdx < FMath::Min(CustomModifiers.Num(), MaxCustomModifiers); CustomIdx++)
+	{
+		const uint32 Bit = 1u << (NumBuiltInModifiers + CustomIdx);
+		for (const FKey& Key : CustomModifiers[CustomIdx].Keys)
+		{
+			if (Key.IsValid())
+			{
+				ModifierKeyBits.Add({ Key, Bit });
+			}
+		}
+	}
+}
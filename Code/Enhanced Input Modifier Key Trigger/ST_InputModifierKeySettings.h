@@ -0,0 +1,61 @@
+// Copyright (C) James Baxter. All Rights Reserved.
+
+#pragma once
+
+#include "Engine/DeveloperSettings.h"
+#include "InputCoreTypes.h"
+#include "ST_InputModifierKeySettings.generated.h"
+
+/*
+* A modifier which is held while any of its keys are held.
+*/
+USTRUCT()
+struct FST_InputModifierKeyDefinition
+{
+	GENERATED_BODY()
+public:
+	UPROPERTY(EditAnywhere, Category = "Input")
+	FName Name;
+
+	UPROPERTY(EditAnywhere, Category = "Input")
+	TArray<FKey> Keys;
+};
+
+/*
+* Modifier Key Registry
+* Shift/Ctrl/Alt/Cmd are always registered. Custom modifiers (e.g, Gamepad Left Shoulder, Thumb Mouse Button) take the
+* remaining slots of EST_InputModifierSlot in order, so reordering them changes the meaning of saved modifier masks.
+*/
+UCLASS(Config = Input, DefaultConfig, meta = (DisplayName = "Modifier Keys"))
+class UST_InputModifierKeySettings final : public UDeveloperSettings
+{
+	GENERATED_BODY()
+public:
+	UST_InputModifierKeySettings();
+
+	virtual void PostInitProperties() override;
+	virtual void PostReloadConfig(FProperty* PropertyThatWasLoaded) override;
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+	/* Every registered key and the modifier bit it holds, flattened for cheap per-frame builds. */
+	struct FKeyBit
+	{
+		FKey Key;
+		uint32 Bit;
+	};
+
+	const TArray<FKeyBit>& GetModifierKeyBits() const { return ModifierKeyBits; }
+	FName GetModifierName(const int32 InSlot) const;
+
+protected:
+	/* Additional modifiers, in slot order after Cmd. Limited to 28. */
+	UPROPERTY(Config, EditAnywhere, Category = "Modifier Keys", meta = (TitleProperty = "Name"))
+	TArray<FST_InputModifierKeyDefinition> CustomModifiers;
+
+private:
+	void RebuildModifierKeyBits();
+
+	TArray<FKeyBit> ModifierKeyBits;
+};
@@ -0,0 +1,276 @@
+// Copyright (C) James Baxter. All Rights Reserved.
+
+#include "ST_InputModifierKeysSubsystem.h"
+
+// Engine
+#include "EnhancedInputSubsystems.h"
+#include "EnhancedPlayerInput.h"
+#include "InputMappingContext.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogST_InputModifierKeys, Log, All);
+
+//////////////////////////
+///// Dispatch Table /////
+//////////////////////////
+
+void FST_InputModifierDispatchTable::Build(const UEnhancedPlayerInput* PlayerInput, TFunctionRef<FST_InputTriggerModifiers(const UST_InputTriggerModifierKeys&)> ResolveModifiers)
+{
+	Reset();
+
+	if (!PlayerInput)
+	{
+		return;
+	}
+
+	TSet<FKey> UngatedKeys;
+	for (const FEnhancedActionKeyMapping& Mapping : PlayerInput->GetEnhancedActionMappings())
+	{
+		bool bGated = false;
+		for (UInputTrigger* Trigger : Mapping.Triggers)
+		{
+			UST_InputTriggerModifierKeys* ModifierTrigger = Cast<UST_InputTriggerModifierKeys>(Trigger);
+			if (!ModifierTrigger)
+			{
+				continue;
+			}
+
+			Entries.FindOrAdd(Mapping.Key).Add({ ResolveModifiers(*ModifierTrigger), ModifierTrigger->MatchMode, ModifierTrigger });
+
+			ModifierTrigger->DispatchTable = this;
+			ModifierTrigger->DispatchKey = Mapping.Key;
+			ModifierTrigger->CachedSerial = 0;
+			BoundTriggers.Add(ModifierTrigger);
+			bGated = true;
+		}
+
+		if (!bGated)
+		{
+			UngatedKeys.Add(Mapping.Key);
+		}
+	}
+
+	// The table can only suppress mappings it knows about. A plain 'S' mapping keeps firing alongside 'Ctrl+S' unless it
+	// carries a Modifier Keys trigger too (an empty one is fine, it matches any modifiers but is always least-specific).
+	// Rebuilds happen on every context change, designers see this through the trigger's data validation instead.
+	for (const FKey& UngatedKey : UngatedKeys)
+	{
+		if (Entries.Contains(UngatedKey))
+		{
+			UE_LOG(LogST_InputModifierKeys, Verbose, TEXT("%s has mappings without a Modifier Keys trigger, they will not be blocked by modifier mappings on the same key"), *UngatedKey.ToString());
+		}
+	}
+
+	// Most-specific first, so the first match during lookup is always the winner.
+	// Stable, so ties resolve in the order the mappings were applied.
+	for (TPair<FKey, TArray<FEntry>>& KeyEntries : Entries)
+	{
+		KeyEntries.Value.StableSort([](const FEntry& LHS, const FEntry& RHS) { return LHS.Modifiers.NumModifiers() > RHS.Modifiers.NumModifiers(); });
+	}
+}
+
+void FST_InputModifierDispatchTable::Reset()
+{
+	for (const TWeakObjectPtr<UST_InputTriggerModifierKeys>& WeakTrigger : BoundTriggers)
+	{
+		UST_InputTriggerModifierKeys* Trigger = WeakTrigger.Get();
+		if (Trigger && Trigger->DispatchTable == this)
+		{
+			Trigger->DispatchTable = nullptr;
+			Trigger->DispatchKey = FKey();
+			Trigger->CachedSerial = 0;
+		}
+	}
+
+	BoundTriggers.Reset();
+	Entries.Reset();
+
+	// Winners may differ under the new table even if no modifier changes
+	HeldModifiersFrame = MAX_uint64;
+	BumpSerial();
+}
+
+const UST_InputTriggerModifierKeys* FST_InputModifierDispatchTable::FindWinner(const FKey& InKey, const FST_InputTriggerModifiers& InHeldModifiers) const
+{
+	if (const TArray<FEntry>* KeyEntries = Entries.Find(InKey))
+	{
+		for (const FEntry& Entry : *KeyEntries)
+		{
+			if (Entry.Modifiers.Matches(InHeldModifiers, Entry.Match))
+			{
+				return Entry.Trigger;
+			}
+		}
+	}
+
+	return nullptr;
+}
+
+uint32 FST_InputModifierDispatchTable::UpdateHeldModifiers(const UPlayerInput* PlayerInput) const
+{
+	if (HeldModifiersFrame != GFrameCounter)
+	{
+		HeldModifiersFrame = GFrameCounter;
+
+		const FST_InputTriggerModifiers NewHeldModifiers = FST_InputTriggerModifiers::FromKeyState(PlayerInput);
+		if (NewHeldModifiers != HeldModifiers)
+		{
+			HeldModifiers = NewHeldModifiers;
+			BumpSerial();
+		}
+	}
+
+	return Serial;
+}
+
+void FST_InputModifierDispatchTable::BumpSerial() const
+{
+	// Zero is reserved for "never evaluated"
+	if (++Serial == 0)
+	{
+		++Serial;
+	}
+}
+
+///////////////////////////////////
+///// Player Mapped Modifiers /////
+///////////////////////////////////
+
+void FST_InputPlayerMappedModifiers::Add(const FName MappingName, const FST_InputTriggerModifiers& Modifiers)
+{
+	MappedModifiers.Add(MappingName, Modifiers);
+	ResolvedCache.Reset();
+}
+
+bool FST_InputPlayerMappedModifiers::Remove(const FName MappingName)
+{
+	if (MappedModifiers.Remove(MappingName) > 0)
+	{
+		ResolvedCache.Reset();
+		return true;
+	}
+
+	return false;
+}
+
+bool FST_InputPlayerMappedModifiers::Reset()
+{
+	if (MappedModifiers.Num() > 0)
+	{
+		MappedModifiers.Reset();
+		ResolvedCache.Reset();
+		return true;
+	}
+
+	return false;
+}
+
+FST_InputTriggerModifiers FST_InputPlayerMappedModifiers::Resolve(const UST_InputTriggerModifierKeys& Trigger)
+{
+	// Only context mappings carry a player mappable name, Action-level triggers are never bound to the table.
+	const UInputMappingContext* TemplateContext = Cast<UInputMappingContext>(Trigger.TemplateOuter.Get());
+	if (!Trigger.bModifiersAreMappable || !TemplateContext)
+	{
+		return Trigger.RequiredModifierKeys;
+	}
+
+	const FTemplateKey TemplateKey = { TemplateContext, Trigger.TemplateMappingIndex, Trigger.TemplateIndex };
+	if (const FST_InputTriggerModifiers* CachedModifiers = ResolvedCache.Find(TemplateKey))
+	{
+		return *CachedModifiers;
+	}
+
+	FST_InputTriggerModifiers Resolved = Trigger.RequiredModifierKeys;
+
+	const TArray<FEnhancedActionKeyMapping>& TemplateMappings = TemplateContext->GetMappings();
+	if (TemplateMappings.IsValidIndex(Trigger.TemplateMappingIndex))
+	{
+		const FEnhancedActionKeyMapping& TemplateMapping = TemplateMappings[Trigger.TemplateMappingIndex];
+		if (TemplateMapping.bIsPlayerMappable)
+		{
+			if (const FST_InputTriggerModifiers* Remapped = MappedModifiers.Find(TemplateMapping.PlayerMappableOptions.Name))
+			{
+				Resolved = *Remapped;
+			}
+		}
+	}
+
+	return ResolvedCache.Add(TemplateKey, Resolved);
+}
+
+/////////////////////
+///// Lifecycle /////
+/////////////////////
+
+void UST_InputModifierKeysSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	if (UEnhancedInputLocalPlayerSubsystem* EISubsystem = Collection.InitializeDependency<UEnhancedInputLocalPlayerSubsystem>())
+	{
+		EISubsystem->ControlMappingsRebuiltDelegate.AddDynamic(this, &UST_InputModifierKeysSubsystem::OnControlMappingsRebuilt);
+	}
+}
+
+void UST_InputModifierKeysSubsystem::Deinitialize()
+{
+	if (UEnhancedInputLocalPlayerSubsystem* EISubsystem = ULocalPlayer::GetSubsystem<UEnhancedInputLocalPlayerSubsystem>(GetLocalPlayer()))
+	{
+		EISubsystem->ControlMappingsRebuiltDelegate.RemoveDynamic(this, &UST_InputModifierKeysSubsystem::OnControlMappingsRebuilt);
+	}
+
+	DispatchTable.Reset();
+
+	Super::Deinitialize();
+}
+
+void UST_InputModifierKeysSubsystem::OnControlMappingsRebuilt()
+{
+	// Applied mappings (and their trigger instances) are regenerated on every rebuild, so the table must be too.
+	RebuildDispatchTable();
+}
+
+void UST_InputModifierKeysSubsystem::RebuildDispatchTable()
+{
+	const UEnhancedInputLocalPlayerSubsystem* EISubsystem = ULocalPlayer::GetSubsystem<UEnhancedInputLocalPlayerSubsystem>(GetLocalPlayer());
+	DispatchTable.Build(EISubsystem ? EISubsystem->GetPlayerInput() : nullptr, [this](const UST_InputTriggerModifierKeys& Trigger) { return PlayerMappedModifiers.Resolve(Trigger); });
+}
+
+///////////////////////////////////
+///// Player Mapped Modifiers /////
+///////////////////////////////////
+
+void UST_InputModifierKeysSubsystem::AddPlayerMappedModifiers(const FName MappingName, const FST_InputTriggerModifiers& Modifiers)
+{
+	if (!MappingName.IsNone())
+	{
+		PlayerMappedModifiers.Add(MappingName, Modifiers);
+		RebuildDispatchTable();
+	}
+}
+
+void UST_InputModifierKeysSubsystem::RemovePlayerMappedModifiers(const FName MappingName)
+{
+	if (PlayerMappedModifiers.Remove(MappingName))
+	{
+		RebuildDispatchTable();
+	}
+}
+
+void UST_InputModifierKeysSubsystem::RemoveAllPlayerMappedModifiers()
+{
+	if (PlayerMappedModifiers.Reset())
+	{
+		RebuildDispatchTable();
+	}
+}
+
+bool UST_InputModifierKeysSubsystem::GetPlayerMappedModifiers(const FName MappingName, FST_InputTriggerModifiers& OutModifiers) const
+{
+	if (const FST_InputTriggerModifiers* Modifiers = PlayerMappedModifiers.Find(MappingName))
+	{
+		OutModifiers = *Modifiers;
+		return true;
+	}
+
+	return false;
+}
@@ -0,0 +1,137 @@
+// Copyright (C) James Baxter. All Rights Reserved.
+
+#pragma once
+
+#include "Subsystems/LocalPlayerSubsystem.h"
+#include "ST_InputTrigger_ModifierKeys.h"
+#include "ST_InputModifierKeysSubsystem.generated.h"
+
+// Declarations
+class UEnhancedPlayerInput;
+
+/*
+* Modifier Dispatch Table
+* Every modifier-gated mapping applied to a player, grouped by key and sorted most-specific first.
+* Mappings without a Modifier Keys trigger are not in the table, and are never blocked by it.
+* Built once when the player's mapping contexts are applied, rather than resolved by each trigger every frame.
+*/
+struct FST_InputModifierDispatchTable
+{
+public:
+	FST_InputModifierDispatchTable() = default;
+	~FST_InputModifierDispatchTable() { Reset(); }
+
+	// Non-copyable, bound triggers point back at this table.
+	FST_InputModifierDispatchTable(const FST_InputModifierDispatchTable&) = delete;
+	FST_InputModifierDispatchTable& operator=(const FST_InputModifierDispatchTable&) = delete;
+
+	/* ResolveModifiers returns the modifiers a bound trigger should require, e.g after user remapping. */
+	void Build(const UEnhancedPlayerInput* PlayerInput, TFunctionRef<FST_InputTriggerModifiers(const UST_InputTriggerModifierKeys&)> ResolveModifiers);
+	void Reset();
+
+	/*
+	* Returns the trigger that owns the key for the given modifier state, or nullptr if no mapping matches.
+	* The most-specific mapping whose required modifiers match wins, ties go to the first mapping applied.
+	*/
+	const UST_InputTriggerModifierKeys* FindWinner(const FKey& InKey, const FST_InputTriggerModifiers& InHeldModifiers) const;
+
+	/*
+	* Builds the held modifiers once per frame for every bound trigger, and returns a serial that only changes when a
+	* modifier is pressed/released or the table is rebuilt. Triggers can keep their last result until it changes.
+	*/
+	uint32 UpdateHeldModifiers(const UPlayerInput* PlayerInput) const;
+	const FST_InputTriggerModifiers& GetHeldModifiers() const { return HeldModifiers; }
+
+private:
+	void BumpSerial() const;
+
+	struct FEntry
+	{
+		FST_InputTriggerModifiers Modifiers;
+		EST_InputModifierMatch Match;
+		const UST_InputTriggerModifierKeys* Trigger;
+	};
+
+	TMap<FKey, TArray<FEntry>> Entries;
+	TArray<TWeakObjectPtr<UST_InputTriggerModifierKeys>> BoundTriggers;
+
+	// Shared per-frame modifier state. Mutable, bound triggers only hold a const table.
+	mutable FST_InputTriggerModifiers HeldModifiers;
+	mutable uint64 HeldModifiersFrame = MAX_uint64;
+	mutable uint32 Serial = 0;
+};
+
+/*
+* Player Mapped Modifiers
+* A player's modifier remaps, keyed by the player mappable name of the mapping (see FPlayerMappableKeyOptions).
+* Each trigger template is resolved against the remaps once, and served from cache until the remaps change.
+*/
+struct FST_InputPlayerMappedModifiers
+{
+public:
+	void Add(const FName MappingName, const FST_InputTriggerModifiers& Modifiers);
+	bool Remove(const FName MappingName);
+	bool Reset();
+
+	const FST_InputTriggerModifiers* Find(const FName MappingName) const { return MappedModifiers.Find(MappingName); }
+
+	/* Modifiers the trigger should require for this player. Only triggers with bModifiersAreMappable can be remapped. */
+	FST_InputTriggerModifiers Resolve(const UST_InputTriggerModifierKeys& Trigger);
+
+private:
+	/* Identifies the asset trigger a runtime copy was made from */
+	struct FTemplateKey
+	{
+		TObjectKey<UObject> Outer;
+		int32 MappingIndex;
+		int32 TriggerIndex;
+
+		bool operator==(const FTemplateKey& RHS) const { return Outer == RHS.Outer && MappingIndex == RHS.MappingIndex && TriggerIndex == RHS.TriggerIndex; }
+		friend uint32 GetTypeHash(const FTemplateKey& Key) { return HashCombine(GetTypeHash(Key.Outer), HashCombine(GetTypeHash(Key.MappingIndex), GetTypeHash(Key.TriggerIndex))); }
+	};
+
+	TMap<FName, FST_InputTriggerModifiers> MappedModifiers;
+
+	/* Resolved modifiers per template, kept until the mapped modifiers change */
+	TMap<FTemplateKey, FST_InputTriggerModifiers> ResolvedCache;
+};
+
+/*
+* Input Modifier Keys Subsystem
+* Keeps a modifier dispatch table in sync with the mapping contexts applied to the local player.
+* Also stores the player's modifier remaps, since the engine's player-mapped keys have no notion of modifiers.
+*/
+UCLASS()
+class UST_InputModifierKeysSubsystem final : public ULocalPlayerSubsystem
+{
+	GENERATED_BODY()
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	/*
+	* Player Mapped Modifiers
+	* Keyed by the player mappable name of the mapping (see FPlayerMappableKeyOptions).
+	* Only applies to triggers which have bModifiersAreMappable set. Saving/loading these is left to the game.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Input|Modifier Keys")
+	void AddPlayerMappedModifiers(const FName MappingName, const FST_InputTriggerModifiers& Modifiers);
+
+	UFUNCTION(BlueprintCallable, Category = "Input|Modifier Keys")
+	void RemovePlayerMappedModifiers(const FName MappingName);
+
+	UFUNCTION(BlueprintCallable, Category = "Input|Modifier Keys")
+	void RemoveAllPlayerMappedModifiers();
+
+	UFUNCTION(BlueprintPure, Category = "Input|Modifier Keys")
+	bool GetPlayerMappedModifiers(const FName MappingName, FST_InputTriggerModifiers& OutModifiers) const;
+
+private:
+	UFUNCTION()
+	void OnControlMappingsRebuilt();
+
+	void RebuildDispatchTable();
+
+	FST_InputPlayerMappedModifiers PlayerMappedModifiers;
+	FST_InputModifierDispatchTable DispatchTable;
+};
@@ -0,0 +1,329 @@
+// Copyright (C) James Baxter. All Rights Reserved.
+
+#include "ST_InputRecording.h"
+
+// Engine
+#include "Framework/Application/SlateApplication.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/DateTime.h"
+#include "Misc/Paths.h"
+#include "Serialization/Archive.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogST_InputRecording, Log, All);
+
+namespace
+{
+	/* Every entry takes at least InMinBytes, so a count larger than the rest of the archive can only come from a corrupt file */
+	bool IsCountPlausible(FArchive& Ar, const uint32 InCount, const int64 InMinBytes)
+	{
+		const int64 TotalSize = Ar.TotalSize();
+		return TotalSize < 0 || static_cast<int64>(InCount) * InMinBytes <= TotalSize - Ar.Tell();
+	}
+}
+
+/////////////////////
+///// Recording /////
+/////////////////////
+
+void FST_InputRecording::Reset()
+{
+	Keys.Reset();
+	KeyLookup.Reset();
+	Frames.Reset();
+	Events.Reset();
+}
+
+void FST_InputRecording::BeginFrame(const float InDeltaTime)
+{
+	FFrame& NewFrame = Frames.AddDefaulted_GetRef();
+	NewFrame.DeltaTime = InDeltaTime;
+	NewFrame.FirstEvent = Events.Num();
+}
+
+void FST_InputRecording::AddEvent(const FKey& InKey, const EInputEvent InEvent)
+{
+	// Events received before the first tick still need a frame to live in
+	if (Frames.Num() == 0)
+	{
+		BeginFrame(0.f);
+	}
+
+	uint16* KeyIndex = KeyLookup.Find(InKey);
+	if (!KeyIndex)
+	{
+		if (!ensureMsgf(Keys.Num() <= MAX_uint16, TEXT("Input Recording key table is full")))
+		{
+			return;
+		}
+
+		KeyIndex = &KeyLookup.Add(InKey, static_cast<uint16>(Keys.Add(InKey)));
+	}
+
+	FEvent& NewEvent = Events.AddDefaulted_GetRef();
+	NewEvent.KeyIndex = *KeyIndex;
+	NewEvent.Event = static_cast<uint8>(InEvent);
+
+	Frames.Last().NumEvents++;
+}
+
+bool FST_InputRecording::SaveToFile(const FString& InFilename) const
+{
+	TUniquePtr<FArchive> FileWriter = TUniquePtr<FArchive>(IFileManager::Get().CreateFileWriter(*InFilename));
+	if (!FileWriter)
+	{
+		UE_LOG(LogST_InputRecording, Error, TEXT("Unable to write Input Recording to '%s'"), *InFilename);
+		return false;
+	}
+
+	*FileWriter << const_cast<FST_InputRecording&>(*this);
+	return FileWriter->Close();
+}
+
+bool FST_InputRecording::LoadFromFile(const FString& InFilename)
+{
+	TUniquePtr<FArchive> FileReader = TUniquePtr<FArchive>(IFileManager::Get().CreateFileReader(*InFilename));
+	if (!FileReader)
+	{
+		UE_LOG(LogST_InputRecording, Error, TEXT("Unable to read Input Recording from '%s'"), *InFilename);
+		return false;
+	}
+
+	*FileReader << *this;
+	if (FileReader->IsError())
+	{
+		UE_LOG(LogST_InputRecording, Error, TEXT("'%s' is not a valid Input Recording"), *InFilename);
+		Reset();
+		return false;
+	}
+
+	return true;
+}
+
+FArchive& operator<<(FArchive& Ar, FST_InputRecording& Recording)
+{
+	uint32 Magic = FST_InputRecording::FileMagic;
+	uint32 Version = FST_InputRecording::FileVersion;
+	Ar << Magic;
+	Ar << Version;
+
+	if (Magic != FST_InputRecording::FileMagic || Version != FST_InputRecording::FileVersion)
+	{
+		Ar.SetError();
+		return Ar;
+	}
+
+	if (Ar.IsLoading())
+	{
+		Recording.Reset();
+	}
+
+	// Key table, stored by name
+	uint32 NumKeys = Recording.Keys.Num();
+	Ar.SerializeIntPacked(NumKeys);
+
+	if (Ar.IsLoading())
+	{
+		// Names are at least a length prefix
+		if (NumKeys > MAX_uint16 + 1u || !IsCountPlausible(Ar, NumKeys, sizeof(int32)))
+		{
+			Ar.SetError();
+			return Ar;
+		}
+
+		Recording.Keys.Reserve(NumKeys);
+	}
+
+	for (uint32 KeyIdx = 0; KeyIdx < NumKeys && !Ar.IsError(); KeyIdx++)
+	{
+		FString KeyName = Ar.IsLoading() ? FString() : Recording.Keys[KeyIdx].GetFName().ToString();
+		Ar << KeyName;
+
+		if (Ar.IsLoading())
+		{
+			const FKey LoadedKey = FKey(FName(*KeyName));
+			Recording.KeyLookup.Add(LoadedKey, static_cast<uint16>(Recording.Keys.Add(LoadedKey)));
+		}
+	}
+
+	// Frames, each followed by its own events
+	uint32 NumFrames = Recording.Frames.Num();
+	Ar.SerializeIntPacked(NumFrames);
+
+	if (Ar.IsLoading())
+	{
+		// Frames are at least a DeltaTime and a packed event count
+		if (NumFrames > static_cast<uint32>(MAX_int32) || !IsCountPlausible(Ar, NumFrames, sizeof(float) + 1))
+		{
+			Ar.SetError();
+			return Ar;
+		}
+
+		Recording.Frames.Reserve(static_cast<int32>(NumFrames));
+	}
+
+	for (uint32 FrameIdx = 0; FrameIdx < NumFrames && !Ar.IsError(); FrameIdx++)
+	{
+		if (Ar.IsLoading())
+		{
+			FST_InputRecording::FFrame& Frame = Recording.Frames.AddDefaulted_GetRef();
+			Frame.FirstEvent = Recording.Events.Num();
+
+			uint32 NumEvents = 0;
+			Ar << Frame.DeltaTime;
+			Ar.SerializeIntPacked(NumEvents);
+
+			// Events are at least a packed key index and the event type
+			if (!IsCountPlausible(Ar, NumEvents, 2))
+			{
+				Ar.SetError();
+				break;
+			}
+
+			for (uint32 EventIdx = 0; EventIdx < NumEvents && !Ar.IsError(); EventIdx++)
+			{
+				uint32 KeyIndex = 0;
+				FST_InputRecording::FEvent& Event = Recording.Events.AddDefaulted_GetRef();
+				Ar.SerializeIntPacked(KeyIndex);
+				Ar << Event.Event;
+
+				if (KeyIndex >= NumKeys || Event.Event >= IE_MAX)
+				{
+					Ar.SetError();
+				}
+
+				Event.KeyIndex = static_cast<uint16>(KeyIndex);
+				Frame.NumEvents++;
+			}
+		}
+		else
+		{
+			FST_InputRecording::FFrame& Frame = Recording.Frames[FrameIdx];
+
+			uint32 NumEvents = Frame.NumEvents;
+			Ar << Frame.DeltaTime;
+			Ar.SerializeIntPacked(NumEvents);
+
+			for (int32 EventIdx = Frame.FirstEvent; EventIdx < Frame.FirstEvent + Frame.NumEvents; EventIdx++)
+			{
+				uint32 KeyIndex = Recording.Events[EventIdx].KeyIndex;
+				Ar.SerializeIntPacked(KeyIndex);
+				Ar << Recording.Events[EventIdx].Event;
+			}
+		}
+	}
+
+	return Ar;
+}
+
+////////////////////
+///// Recorder /////
+////////////////////
+
+void FST_InputRecorder::Tick(const float DeltaTime, FSlateApplication& SlateApp, TSharedRef<ICursor> Cursor)
+{
+	Recording.BeginFrame(DeltaTime);
+}
+
+bool FST_InputRecorder::HandleKeyDownEvent(FSlateApplication& SlateApp, const FKeyEvent& InKeyEvent)
+{
+	Record(InKeyEvent.GetUserIndex(), InKeyEvent.GetKey(), InKeyEvent.IsRepeat() ? IE_Repeat : IE_Pressed);
+	return false;
+}
+
+bool FST_InputRecorder::HandleKeyUpEvent(FSlateApplication& SlateApp, const FKeyEvent& InKeyEvent)
+{
+	Record(InKeyEvent.GetUserIndex(), InKeyEvent.GetKey(), IE_Released);
+	return false;
+}
+
+bool FST_InputRecorder::HandleMouseButtonDownEvent(FSlateApplication& SlateApp, const FPointerEvent& MouseEvent)
+{
+	Record(MouseEvent.GetUserIndex(), MouseEvent.GetEffectingButton(), IE_Pressed);
+	return false;
+}
+
+bool FST_InputRecorder::HandleMouseButtonUpEvent(FSlateApplication& SlateApp, const FPointerEvent& MouseEvent)
+{
+	Record(MouseEvent.GetUserIndex(), MouseEvent.GetEffectingButton(), IE_Released);
+	return false;
+}
+
+bool FST_InputRecorder::HandleMouseButtonDoubleClickEvent(FSlateApplication& SlateApp, const FPointerEvent& MouseEvent)
+{
+	// Slate delivers the second press of a double click only through here. Recorded as the viewport sends it,
+	// UPlayerInput counts IE_DoubleClick as a press too, so Pressed/Released stay balanced on replay.
+	Record(MouseEvent.GetUserIndex(), MouseEvent.GetEffectingButton(), IE_DoubleClick);
+	return false;
+}
+
+void FST_InputRecorder::Record(const uint32 InUserIndex, const FKey& InKey, const EInputEvent InEvent)
+{
+	if (InUserIndex == static_cast<uint32>(UserIndex) && InKey.IsValid())
+	{
+		Recording.AddEvent(InKey, InEvent);
+	}
+}
+
+////////////////////////////
+///// Console Commands /////
+////////////////////////////
+
+namespace
+{
+	TSharedPtr<FST_InputRecorder> GActiveRecorder;
+
+	void StartInputRecording(const TArray<FString>& Args)
+	{
+		if (!FSlateApplication::IsInitialized())
+		{
+			UE_LOG(LogST_InputRecording, Warning, TEXT("Input Recording requires Slate"));
+			return;
+		}
+
+		if (GActiveRecorder.IsValid())
+		{
+			FSlateApplication::Get().UnregisterInputPreProcessor(GActiveRecorder);
+		}
+
+		const int32 UserIndex = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 0;
+		GActiveRecorder = MakeShared<FST_InputRecorder>(UserIndex);
+		FSlateApplication::Get().RegisterInputPreProcessor(GActiveRecorder, 0);
+
+		UE_LOG(LogST_InputRecording, Display, TEXT("Recording input for User %i"), UserIndex);
+	}
+
+	void StopInputRecording(const TArray<FString>& Args)
+	{
+		if (!GActiveRecorder.IsValid())
+		{
+			UE_LOG(LogST_InputRecording, Warning, TEXT("No Input Recording in progress"));
+			return;
+		}
+
+		if (FSlateApplication::IsInitialized())
+		{
+			FSlateApplication::Get().UnregisterInputPreProcessor(GActiveRecorder);
+		}
+
+		const FST_InputRecording& Recording = GActiveRecorder->GetRecording();
+		const FString Filename = Args.Num() > 0 ? Args[0] : FPaths::ProjectSavedDir() / TEXT("InputRecordings") / FString::Printf(TEXT("Input_%s.stir"), *FDateTime::Now().ToString());
+
+		if (Recording.SaveToFile(Filename))
+		{
+			UE_LOG(LogST_InputRecording, Display, TEXT("Saved %i frames (%i events) to '%s'"), Recording.NumFrames(), Recording.NumEvents(), *Filename);
+		}
+
+		GActiveRecorder.Reset();
+	}
+
+	FAutoConsoleCommand StartInputRecordingCmd(
+		TEXT("ST.Input.Record.Start"),
+		TEXT("Starts recording raw key events for replay/benchmarking. Optional: UserIndex (default 0)"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&StartInputRecording));
+
+	FAutoConsoleCommand StopInputRecordingCmd(
+		TEXT("ST.Input.Record.Stop"),
+		TEXT("Stops recording and saves the recording. Optional: Filename (default Saved/InputRecordings)"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&StopInputRecording));
+}
@@ -0,0 +1,89 @@
+// Copyright (C) James Baxter. All Rights Reserved.
+
+#pragma once
+
+#include "InputCoreTypes.h"
+#include "Engine/EngineBaseTypes.h"
+#include "Framework/Application/IInputProcessor.h"
+
+/*
+* Input Recording
+* A compact stream of raw key events, grouped into frames, that can be replayed through a UPlayerInput.
+*
+* Layout: Header, Key name table, then per frame a DeltaTime followed by a packed event count and packed events.
+* Analog axis input is not recorded, only key/button state (which includes the modifier keys).
+*/
+struct FST_InputRecording
+{
+public:
+	struct FEvent
+	{
+		uint16 KeyIndex = 0;
+		uint8 Event = IE_Pressed;
+	};
+
+	struct FFrame
+	{
+		float DeltaTime = 0.f;
+		int32 FirstEvent = 0;
+		int32 NumEvents = 0;
+	};
+
+	void Reset();
+
+	void BeginFrame(const float InDeltaTime);
+	void AddEvent(const FKey& InKey, const EInputEvent InEvent);
+
+	int32 NumFrames() const { return Frames.Num(); }
+	int32 NumEvents() const { return Events.Num(); }
+
+	const FFrame& GetFrame(const int32 InFrameIndex) const { return Frames[InFrameIndex]; }
+	const FEvent& GetEvent(const int32 InEventIndex) const { return Events[InEventIndex]; }
+	const FKey& GetKey(const FEvent& InEvent) const { return Keys[InEvent.KeyIndex]; }
+	const TArray<FKey>& GetKeys() const { return Keys; }
+
+	bool SaveToFile(const FString& InFilename) const;
+	bool LoadFromFile(const FString& InFilename);
+
+	friend FArchive& operator<<(FArchive& Ar, FST_InputRecording& Recording);
+
+private:
+	static constexpr uint32 FileMagic = 0x52495453; // "STIR"
+	static constexpr uint32 FileVersion = 1;
+
+	TArray<FKey> Keys;
+	TMap<FKey, uint16> KeyLookup;
+
+	TArray<FFrame> Frames;
+	TArray<FEvent> Events;
+};
+
+/*
+* Input Recorder
+* Slate input pre-processor that captures key events for a single user without consuming them.
+* Use 'ST.Input.Record.Start [UserIndex]' and 'ST.Input.Record.Stop <Filename>' from the console.
+*/
+class FST_InputRecorder : public IInputProcessor
+{
+public:
+	explicit FST_InputRecorder(const int32 InUserIndex)
+		: UserIndex(InUserIndex)
+	{}
+
+	// IInputProcessor Interface
+	virtual void Tick(const float DeltaTime, FSlateApplication& SlateApp, TSharedRef<ICursor> Cursor) override;
+	virtual bool HandleKeyDownEvent(FSlateApplication& SlateApp, const FKeyEvent& InKeyEvent) override;
+	virtual bool HandleKeyUpEvent(FSlateApplication& SlateApp, const FKeyEvent& InKeyEvent) override;
+	virtual bool HandleMouseButtonDownEvent(FSlateApplication& SlateApp, const FPointerEvent& MouseEvent) override;
+	virtual bool HandleMouseButtonUpEvent(FSlateApplication& SlateApp, const FPointerEvent& MouseEvent) override;
+	virtual bool HandleMouseButtonDoubleClickEvent(FSlateApplication& SlateApp, const FPointerEvent& MouseEvent) override;
+	virtual const TCHAR* GetDebugName() const override { return TEXT("ST_InputRecorder"); }
+
+	const FST_InputRecording& GetRecording() const { return Recording; }
+
+private:
+	void Record(const uint32 InUserIndex, const FKey& InKey, const EInputEvent InEvent);
+
+	FST_InputRecording Recording;
+	int32 UserIndex;
+};
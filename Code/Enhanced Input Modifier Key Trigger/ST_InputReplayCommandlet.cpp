@@ -0,0 +1,317 @@
+// Copyright (C) James Baxter. All Rights Reserved.
+
+#include "ST_InputReplayCommandlet.h"
+#include "ST_InputModifierKeysSubsystem.h"
+#include "ST_InputRecording.h"
+#include "ST_InputTrigger_ModifierKeys.h"
+
+// Engine
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "EnhancedPlayerInput.h"
+#include "GameFramework/PlayerController.h"
+#include "InputAction.h"
+#include "InputMappingContext.h"
+#include "Math/RandomStream.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogST_InputReplay, Log, All);
+
+namespace
+{
+	uint64 GetTotalAllocationCalls()
+	{
+#if !UE_BUILD_SHIPPING
+		return FMalloc::TotalMallocCalls + FMalloc::TotalReallocCalls;
+#else
+		return 0;
+#endif
+	}
+
+	/* Deterministic stream of modifier toggles and key taps, for when no recording is supplied */
+	void MakeSyntheticRecording(FST_InputRecording& OutRecording, const int32 InSeed, const int32 InNumFrames)
+	{
+		const FKey Modifiers[] = { EKeys::LeftShift, EKeys::LeftControl, EKeys::LeftAlt, EKeys::LeftCommand };
+		const FKey Keys[] = { EKeys::A, EKeys::S, EKeys::D, EKeys::F, EKeys::Q, EKeys::W, EKeys::E, EKeys::R, EKeys::SpaceBar, EKeys::LeftMouseButton };
+
+		FRandomStream Stream(InSeed);
+		bool bModifierHeld[UE_ARRAY_COUNT(Modifiers)] = {};
+		bool bKeyHeld[UE_ARRAY_COUNT(Keys)] = {};
+
+		OutRecording.Reset();
+		for (int32 FrameIdx = 0; FrameIdx < InNumFrames; FrameIdx++)
+		{
+			OutRecording.BeginFrame(1.f / 60.f);
+
+			// Modifiers change a few times a second, keys more often.
+			if (Stream.FRand() < 0.05f)
+			{
+				const int32 ModIdx = Stream.RandHelper(UE_ARRAY_COUNT(Modifiers));
+				bModifierHeld[ModIdx] = !bModifierHeld[ModIdx];
+				OutRecording.AddEvent(Modifiers[ModIdx], bModifierHeld[ModIdx] ? IE_Pressed : IE_Released);
+			}
+
+			if (Stream.FRand() < 0.2f)
+			{
+				const int32 KeyIdx = Stream.RandHelper(UE_ARRAY_COUNT(Keys));
+				bKeyHeld[KeyIdx] = !bKeyHeld[KeyIdx];
+				OutRecording.AddEvent(Keys[KeyIdx], bKeyHeld[KeyIdx] ? IE_Pressed : IE_Released);
+			}
+		}
+	}
+
+	/* Builds contexts where every mapping is gated by a modifier trigger, cycling through every modifier combination */
+	void MakeBenchmarkContexts(TArray<UInputMappingContext*>& OutContexts, const TArray<FKey>& InKeys, const int32 InNumContexts, const int32 InNumTriggers)
+	{
+		for (int32 ContextIdx = 0; ContextIdx < InNumContexts; ContextIdx++)
+		{
+			UInputMappingContext* Context = NewObject<UInputMappingContext>(GetTransientPackage(), NAME_None, RF_Transient);
+			OutContexts.Add(Context);
+
+			for (int32 TriggerIdx = 0; TriggerIdx < InNumTriggers; TriggerIdx++)
+			{
+				UInputAction* Action = NewObject<UInputAction>(GetTransientPackage(), NAME_None, RF_Transient);
+				FEnhancedActionKeyMapping& Mapping = Context->MapKey(Action, InKeys[(ContextIdx * InNumTriggers + TriggerIdx) % InKeys.Num()]);
+
+				UST_InputTriggerModifierKeys* Trigger = NewObject<UST_InputTriggerModifierKeys>(Context, NAME_None, RF_Transient);
+				Trigger->SetRequiredModifierKeys(FST_InputTriggerModifiers((TriggerIdx & 1) != 0, (TriggerIdx & 2) != 0, (TriggerIdx & 4) != 0, (TriggerIdx & 8) != 0));
+				Mapping.Triggers.Add(Trigger);
+			}
+		}
+	}
+
+	/*
+	* Remaps a player mappable mapping in its own context, and checks the dispatch table hands the key to it under the
+	* remapped modifiers rather than the ones it was authored with. Goes through the same template link as a real player.
+	*/
+	bool VerifyPlayerMappedModifiers(UST_InputReplayInputSubsystem* InInputSubsystem)
+	{
+		const FName MappingName = TEXT("ST_InputReplay_Remap");
+		const FKey Key = EKeys::F12;
+		const FST_InputTriggerModifiers Authored(FST_InputTriggerModifiers::Shift);
+		const FST_InputTriggerModifiers Remapped(FST_InputTriggerModifiers::Ctrl | FST_InputTriggerModifiers::Alt);
+
+		UInputMappingContext* Context = NewObject<UInputMappingContext>(GetTransientPackage(), NAME_None, RF_Transient);
+
+		// Unmodified mapping on the same key, which wins whenever the remapped one doesn't
+		UST_InputTriggerModifierKeys* PlainTrigger = NewObject<UST_InputTriggerModifierKeys>(Context, NAME_None, RF_Transient);
+		Context->MapKey(NewObject<UInputAction>(GetTransientPackage(), NAME_None, RF_Transient), Key).Triggers.Add(PlainTrigger);
+
+		FEnhancedActionKeyMapping& Mapping = Context->MapKey(NewObject<UInputAction>(GetTransientPackage(), NAME_None, RF_Transient), Key);
+		Mapping.bIsPlayerMappable = true;
+		Mapping.PlayerMappableOptions.Name = MappingName;
+
+		UST_InputTriggerModifierKeys* Trigger = NewObject<UST_InputTriggerModifierKeys>(Context, NAME_None, RF_Transient);
+		Trigger->SetRequiredModifierKeys(Authored);
+		Mapping.Triggers.Add(Trigger);
+
+		FModifyContextOptions ContextOptions;
+		ContextOptions.bForceImmediately = true;
+		InInputSubsystem->AddMappingContext(Context, 0, ContextOptions);
+
+		// The applied trigger is a copy, find it by the mapping it came from.
+		const UInputTrigger* AppliedTrigger = nullptr;
+		for (const FEnhancedActionKeyMapping& AppliedMapping : InInputSubsystem->GetPlayerInput()->GetEnhancedActionMappings())
+		{
+			if (AppliedMapping.bIsPlayerMappable && AppliedMapping.PlayerMappableOptions.Name == MappingName && AppliedMapping.Triggers.Num() > 0)
+			{
+				AppliedTrigger = AppliedMapping.Triggers[0];
+			}
+		}
+
+		FST_InputPlayerMappedModifiers MappedModifiers;
+		MappedModifiers.Add(MappingName, Remapped);
+
+		FST_InputModifierDispatchTable DispatchTable;
+		DispatchTable.Build(InInputSubsystem->GetPlayerInput(), [&MappedModifiers](const UST_InputTriggerModifierKeys& InTrigger) { return MappedModifiers.Resolve(InTrigger); });
+
+		const bool bRemappedWins = AppliedTrigger && DispatchTable.FindWinner(Key, Remapped) == AppliedTrigger;
+		const bool bAuthoredLoses = AppliedTrigger && DispatchTable.FindWinner(Key, Authored) != AppliedTrigger;
+
+		DispatchTable.Reset();
+		InInputSubsystem->RemoveMappingContext(Context, ContextOptions);
+
+		if (!bRemappedWins || !bAuthoredLoses)
+		{
+			UE_LOG(LogST_InputReplay, Error, TEXT("Player Mapped Modifiers not applied: %s [%s] - %s [%s]"),
+				*Remapped.ToString(), bRemappedWins ? TEXT("Wins") : TEXT("Loses"),
+				*Authored.ToString(), bAuthoredLoses ? TEXT("Loses") : TEXT("Wins"));
+			return false;
+		}
+
+		UE_LOG(LogST_InputReplay, Display, TEXT("Player Mapped Modifiers verified: %s remapped to %s"), *Authored.ToString(), *Remapped.ToString());
+		return true;
+	}
+
+	double Percentile(const TArray<double>& InSorted, const double InPercentile)
+	{
+		return InSorted.Num() > 0 ? InSorted[FMath::Clamp(FMath::FloorToInt(InPercentile * InSorted.Num()), 0, InSorted.Num() - 1)] : 0.0;
+	}
+}
+
+///////////////////////
+///// Constructor /////
+///////////////////////
+
+UST_InputReplayCommandlet::UST_InputReplayCommandlet()
+	: Super()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+////////////////
+///// Main /////
+////////////////
+
+int32 UST_InputReplayCommandlet::Main(const FString& Params)
+{
+	FString RecordingFile;
+	int32 NumContexts = 4;
+	int32 NumTriggers = 16;
+	int32 NumLoops = 1;
+	int32 Seed = 0;
+
+	FParse::Value(*Params, TEXT("Recording="), RecordingFile);
+	FParse::Value(*Params, TEXT("Contexts="), NumContexts);
+	FParse::Value(*Params, TEXT("Triggers="), NumTriggers);
+	FParse::Value(*Params, TEXT("Loops="), NumLoops);
+	FParse::Value(*Params, TEXT("Seed="), Seed);
+	const bool bUseDispatchTable = !FParse::Param(*Params, TEXT("NoDispatchTable"));
+
+	NumContexts = FMath::Max(NumContexts, 1);
+	NumTriggers = FMath::Max(NumTriggers, 1);
+	NumLoops = FMath::Max(NumLoops, 1);
+
+	// Input Stream
+	FST_InputRecording Recording;
+	if (!RecordingFile.IsEmpty())
+	{
+		if (!Recording.LoadFromFile(RecordingFile))
+		{
+			return 1;
+		}
+	}
+	else
+	{
+		MakeSyntheticRecording(Recording, Seed, 3600);
+	}
+
+	// Map the keys the stream actually uses, so triggers have something to evaluate.
+	TArray<FKey> MappedKeys;
+	for (const FKey& Key : Recording.GetKeys())
+	{
+		if (!Key.IsModifierKey())
+		{
+			MappedKeys.Add(Key);
+		}
+	}
+
+	if (MappedKeys.Num() == 0)
+	{
+		UE_LOG(LogST_InputReplay, Error, TEXT("Input stream contains no non-modifier keys to map"));
+		return 1;
+	}
+
+	// Headless Player
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("ST_InputReplay"));
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.ObjectFlags |= RF_Transient;
+	APlayerController* PlayerController = World->SpawnActor<APlayerController>(SpawnParams);
+	UEnhancedPlayerInput* PlayerInput = NewObject<UEnhancedPlayerInput>(PlayerController);
+	PlayerController->PlayerInput = PlayerInput;
+
+	UST_InputReplayInputSubsystem* InputSubsystem = NewObject<UST_InputReplayInputSubsystem>();
+	InputSubsystem->PlayerInput = PlayerInput;
+
+	if (bUseDispatchTable && !VerifyPlayerMappedModifiers(InputSubsystem))
+	{
+		GEngine->DestroyWorldContext(World);
+		World->DestroyWorld(false);
+		return 1;
+	}
+
+	TArray<UInputMappingContext*> Contexts;
+	MakeBenchmarkContexts(Contexts, MappedKeys, NumContexts, NumTriggers);
+
+	FModifyContextOptions ContextOptions;
+	ContextOptions.bForceImmediately = true;
+	for (int32 ContextIdx = 0; ContextIdx < Contexts.Num(); ContextIdx++)
+	{
+		InputSubsystem->AddMappingContext(Contexts[ContextIdx], ContextIdx, ContextOptions);
+	}
+
+	FST_InputModifierDispatchTable DispatchTable;
+	if (bUseDispatchTable)
+	{
+		DispatchTable.Build(PlayerInput, [](const UST_InputTriggerModifierKeys& Trigger) { return Trigger.GetRequiredModifierKeys(); });
+	}
+
+	// Replay
+	const int32 TotalFrames = Recording.NumFrames() * NumLoops;
+	TArray<double> FrameMicroseconds;
+	TArray<uint64> FrameAllocations;
+	FrameMicroseconds.Reserve(TotalFrames);
+	FrameAllocations.Reserve(TotalFrames);
+
+	const TArray<UInputComponent*> EmptyInputStack;
+	for (int32 LoopIdx = 0; LoopIdx < NumLoops; LoopIdx++)
+	{
+		for (int32 FrameIdx = 0; FrameIdx < Recording.NumFrames(); FrameIdx++)
+		{
+			const FST_InputRecording::FFrame& Frame = Recording.GetFrame(FrameIdx);
+			for (int32 EventIdx = Frame.FirstEvent; EventIdx < Frame.FirstEvent + Frame.NumEvents; EventIdx++)
+			{
+				const FST_InputRecording::FEvent& Event = Recording.GetEvent(EventIdx);
+				const EInputEvent InputEvent = static_cast<EInputEvent>(Event.Event);
+				PlayerInput->InputKey(FInputKeyParams(Recording.GetKey(Event), InputEvent, InputEvent == IE_Released ? 0.0 : 1.0, false));
+			}
+
+			// Nothing ticks the engine here, advance the frame ourselves so per-frame caches behave as they would in game.
+			GFrameCounter++;
+
+			const uint64 StartAllocations = GetTotalAllocationCalls();
+			const uint64 StartCycles = FPlatformTime::Cycles64();
+
+			PlayerInput->ProcessInputStack(EmptyInputStack, Frame.DeltaTime, false);
+
+			const uint64 EndCycles = FPlatformTime::Cycles64();
+			const uint64 EndAllocations = GetTotalAllocationCalls();
+
+			FrameMicroseconds.Add(FPlatformTime::ToMilliseconds64(EndCycles - StartCycles) * 1000.0);
+			FrameAllocations.Add(EndAllocations - StartAllocations);
+		}
+
+		PlayerInput->FlushPressedKeys();
+	}
+
+	// Report
+	double TotalMicroseconds = 0.0;
+	uint64 TotalAllocations = 0;
+	uint64 MaxAllocations = 0;
+	for (int32 FrameIdx = 0; FrameIdx < FrameMicroseconds.Num(); FrameIdx++)
+	{
+		TotalMicroseconds += FrameMicroseconds[FrameIdx];
+		TotalAllocations += FrameAllocations[FrameIdx];
+		MaxAllocations = FMath::Max(MaxAllocations, FrameAllocations[FrameIdx]);
+	}
+
+	TArray<double> SortedMicroseconds = FrameMicroseconds;
+	SortedMicroseconds.Sort();
+
+	const int32 NumFrames = FMath::Max(FrameMicroseconds.Num(), 1);
+	UE_LOG(LogST_InputReplay, Display, TEXT("Input Replay: %i Frames, %i Events, %i Contexts x %i Triggers, Dispatch Table [%s]"), FrameMicroseconds.Num(), Recording.NumEvents() * NumLoops, NumContexts, NumTriggers, bUseDispatchTable ? TEXT("On") : TEXT("Off"));
+	UE_LOG(LogST_InputReplay, Display, TEXT("  Evaluation (us): Avg %.2f - P50 %.2f - P99 %.2f - Max %.2f"), TotalMicroseconds / NumFrames, Percentile(SortedMicroseconds, 0.5), Percentile(SortedMicroseconds, 0.99), SortedMicroseconds.Num() > 0 ? SortedMicroseconds.Last() : 0.0);
+	UE_LOG(LogST_InputReplay, Display, TEXT("  Allocations: Avg %.2f - Max %llu - Total %llu"), static_cast<double>(TotalAllocations) / NumFrames, MaxAllocations, TotalAllocations);
+
+	// Cleanup
+	DispatchTable.Reset();
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+
+	return 0;
+}
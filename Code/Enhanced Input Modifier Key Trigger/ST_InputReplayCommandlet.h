@@ -0,0 +1,45 @@
+// Copyright (C) James Baxter. All Rights Reserved.
+
+#pragma once
+
+#include "Commandlets/Commandlet.h"
+#include "EnhancedInputSubsystemInterface.h"
+#include "ST_InputReplayCommandlet.generated.h"
+
+// Declarations
+class UEnhancedPlayerInput;
+
+/*
+* Minimal Enhanced Input subsystem for the replay commandlet, which has no LocalPlayer to host the real one.
+*/
+UCLASS(Transient)
+class UST_InputReplayInputSubsystem final : public UObject, public IEnhancedInputSubsystemInterface
+{
+	GENERATED_BODY()
+public:
+	virtual UEnhancedPlayerInput* GetPlayerInput() const override { return PlayerInput; }
+
+	UPROPERTY()
+	TObjectPtr<UEnhancedPlayerInput> PlayerInput;
+};
+
+/*
+* Input Replay Commandlet
+* Replays an input recording (see FST_InputRecording) through UEnhancedPlayerInput headless, and reports the
+* per-frame cost of trigger evaluation. Intended as a regression benchmark for input latency work.
+*
+* UnrealEditor-Cmd.exe <Project> -run=ST_InputReplay -nullrhi [-Recording=<File>] [-Contexts=4] [-Triggers=16] [-Loops=1] [-Seed=0] [-NoDispatchTable]
+*
+* Without a recording, a deterministic synthetic stream is generated from Seed.
+* With the dispatch table on, player mapped modifiers are verified against a remapped mapping first, and the commandlet fails if they aren't applied.
+* Allocation counts are unavailable in Shipping builds.
+*/
+UCLASS()
+class UST_InputReplayCommandlet final : public UCommandlet
+{
+	GENERATED_BODY()
+public:
+	UST_InputReplayCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -1,10 +1,173 @@
 // Copyright (C) James Baxter. All Rights Reserved.
 
 #include "ST_InputTrigger_ModifierKeys.h"
+#include "ST_InputModifierKeySettings.h"
+#include "ST_InputModifierKeysSubsystem.h"
 
 // Engine
 #include "EnhancedPlayerInput.h"
 #include "InputMappingContext.h"
+#include "Serialization/CustomVersion.h"
+#include "UObject/ObjectSaveContext.h"
+#include "UObject/Package.h"
+#include "UObject/PropertyPortFlags.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogST_InputTriggerModifierKeys, Log, All);
+
+namespace
+{
+	/* Data versions of UST_InputTriggerModifierKeys */
+	enum class EST_InputModifierKeysVersion : int32
+	{
+		BeforeCustomVersionWasAdded = 0,
+		// MatchMode added. Older triggers always matched their modifiers exactly.
+		AddedMatchMode,
+
+		VersionPlusOne,
+		LatestVersion = VersionPlusOne - 1
+	};
+
+	const FGuid ST_InputModifierKeysVersionGUID(0x6A1F3C52, 0x8E4B4D17, 0xA39C0B7E, 0x52D4F1A8);
+	FCustomVersionRegistration GRegisterST_InputModifierKeysVersion(ST_InputModifierKeysVersionGUID, static_cast<int32>(EST_InputModifierKeysVersion::LatestVersion), TEXT("ST_InputModifierKeysVer"));
+}
+
+//////////////////////////////
+///// Template Locations /////
+//////////////////////////////
+
+namespace
+{
+	/* Where a trigger lives within its outer context */
+	struct FST_TemplateLocation
+	{
+		int32 MappingIndex;
+		int32 TriggerIndex;
+	};
+
+	/*
+	* Trigger locations for each context currently being saved or cooked.
+	* Built once by the first trigger of a context to save and shared by the rest, released once the package is saved.
+	*/
+	TMap<TObjectKey<UInputMappingContext>, TMap<TObjectKey<UInputTrigger>, FST_TemplateLocation>> GTemplateLocations;
+
+	void ReleaseTemplateLocations(const FString& PackageFileName, UPackage* Package, FObjectPostSaveContext SaveContext)
+	{
+		for (auto It = GTemplateLocations.CreateIterator(); It; ++It)
+		{
+			const UInputMappingContext* Context = It.Key().ResolveObjectPtr();
+			if (!Context || Context->GetPackage() == Package)
+			{
+				It.RemoveCurrent();
+			}
+		}
+	}
+
+	bool IsTemplateLocationValid(const UInputMappingContext* Context, const UInputTrigger* Trigger, const FST_TemplateLocation& Location)
+	{
+		const TArray<FEnhancedActionKeyMapping>& Mappings = Context->GetMappings();
+		return Mappings.IsValidIndex(Location.MappingIndex)
+			&& Mappings[Location.MappingIndex].Triggers.IsValidIndex(Location.TriggerIndex)
+			&& Mappings[Location.MappingIndex].Triggers[Location.TriggerIndex] == Trigger;
+	}
+
+	const FST_TemplateLocation* FindTemplateLocation(const UInputMappingContext* Context, const UInputTrigger* Trigger)
+	{
+		static FDelegateHandle PackageSavedHandle = UPackage::PackageSavedWithContextEvent.AddStatic(&ReleaseTemplateLocations);
+
+		// Cheap to validate, so a context edited since the cache was built just costs a rebuild.
+		if (const TMap<TObjectKey<UInputTrigger>, FST_TemplateLocation>* Locations = GTemplateLocations.Find(Context))
+		{
+			const FST_TemplateLocation* Location = Locations->Find(Trigger);
+			if (Location && Location->MappingIndex == INDEX_NONE)
+			{
+				// Already known to be unreferenced this pass
+				return nullptr;
+			}
+
+			if (Location && IsTemplateLocationValid(Context, Trigger, *Location))
+			{
+				return Location;
+			}
+		}
+
+		TMap<TObjectKey<UInputTrigger>, FST_TemplateLocation>& Locations = GTemplateLocations.Add(Context);
+
+		const TArray<FEnhancedActionKeyMapping>& Mappings = Context->GetMappings();
+		for (int32 MappingIdx = 0; MappingIdx < Mappings.Num(); MappingIdx++)
+		{
+			const FEnhancedActionKeyMapping& Mapping = Mappings[MappingIdx];
+			for (int32 TriggerIdx = 0; TriggerIdx < Mapping.Triggers.Num(); TriggerIdx++)
+			{
+				if (Mapping.Triggers[TriggerIdx])
+				{
+					Locations.Add(Mapping.Triggers[TriggerIdx].Get(), FST_TemplateLocation{ MappingIdx, TriggerIdx });
+				}
+			}
+		}
+
+		// Outered to the context but not referenced by any mapping, e.g cleared in the details panel but not yet collected.
+		// Remember it, so other unreferenced triggers don't each force another rebuild.
+		if (!Locations.Contains(Trigger))
+		{
+			Locations.Add(Trigger, FST_TemplateLocation{ INDEX_NONE, INDEX_NONE });
+			return nullptr;
+		}
+
+		return Locations.Find(Trigger);
+	}
+}
+
+////////////////////////
+///// Modifier Set /////
+////////////////////////
+
+FST_InputTriggerModifiers FST_InputTriggerModifiers::FromKeyState(const UPlayerInput* PlayerInput)
+{
+	uint32 HeldMask = 0;
+	for (const UST_InputModifierKeySettings::FKeyBit& KeyBit : GetDefault<UST_InputModifierKeySettings>()->GetModifierKeyBits())
+	{
+		// Skip the lookup if another key already holds this modifier (e.g, Left/Right Shift)
+		if ((HeldMask & KeyBit.Bit) == 0 && PlayerInput->IsPressed(KeyBit.Key))
+		{
+			HeldMask |= KeyBit.Bit;
+		}
+	}
+
+	return FST_InputTriggerModifiers(HeldMask);
+}
+
+FString FST_InputTriggerModifiers::ToString() const
+{
+	const UST_InputModifierKeySettings* Settings = GetDefault<UST_InputModifierKeySettings>();
+
+	FString Result;
+	for (int32 Slot = 0; Slot < MaxModifiers; Slot++)
+	{
+		if (GetMask() & (1u << Slot))
+		{
+			const FName SlotName = Settings->GetModifierName(Slot);
+			Result += Result.IsEmpty() ? TEXT("") : TEXT(" + ");
+			Result += SlotName.IsNone() ? FString::Printf(TEXT("Slot [%i]"), Slot) : SlotName.ToString();
+		}
+	}
+
+	return Result.IsEmpty() ? TEXT("None") : Result;
+}
+
+void FST_InputTriggerModifiers::PostSerialize(const FArchive& Ar)
+{
+#if WITH_EDITORONLY_DATA
+	if (Ar.IsLoading() && (bShift_DEPRECATED || bCtrl_DEPRECATED || bAlt_DEPRECATED || bCmd_DEPRECATED))
+	{
+		Bits |= FST_InputTriggerModifiers(bShift_DEPRECATED, bCtrl_DEPRECATED, bAlt_DEPRECATED, bCmd_DEPRECATED).Bits;
+
+		bShift_DEPRECATED = false;
+		bCtrl_DEPRECATED = false;
+		bAlt_DEPRECATED = false;
+		bCmd_DEPRECATED = false;
+	}
+#endif
+}
 
 /////////////////////////
 ///// Modifier Keys /////
@@ -14,62 +177,136 @@ UST_InputTriggerModifierKeys::UST_InputTriggerModifierKeys(const FObjectInitiali
 	: Super(OI)
 {}
 
+void UST_InputTriggerModifierKeys::Serialize(FArchive& Ar)
+{
+	// Source of a duplicate, e.g a context being applied to a player. Make sure the link is current before it's copied,
+	// so triggers added since the asset was last saved (or loaded without indices) still resolve remaps.
+	if (Ar.IsSaving() && Ar.HasAnyPortFlags(PPF_Duplicate) && !IsTemplate())
+	{
+		RestoreTemplateLink();
+	}
+
+	Ar.UsingCustomVersion(ST_InputModifierKeysVersionGUID);
+
+	Super::Serialize(Ar);
+
+	// MatchMode defaults to AtLeast, which would let an existing Shift+A fire while Ctrl+Shift+A is held.
+	if (Ar.IsLoading() && Ar.CustomVer(ST_InputModifierKeysVersionGUID) < static_cast<int32>(EST_InputModifierKeysVersion::AddedMatchMode))
+	{
+		MatchMode = EST_InputModifierMatch::Exactly;
+	}
+
+	// TemplateOuter is transient, so it's only written for duplicates. Never on disk.
+	if (Ar.HasAnyPortFlags(PPF_Duplicate))
+	{
+		Ar << TemplateOuter;
+	}
+}
+
 void UST_InputTriggerModifierKeys::PreSave(FObjectPreSaveContext SaveContext)
 {
 	Super::PreSave(SaveContext);
 
+	TemplateOuter = nullptr;
+	TemplateMappingIndex = INDEX_NONE;
+	TemplateIndex = INDEX_NONE;
+
 	const UObject* Parent = GetOuter();
 	if (!Parent->HasAnyFlags(RF_Transient) && bModifiersAreMappable)
 	{
-		if (const UInputMappingContext* OuterContext = Cast<UInputMappingContext>(GetOuter()))
+		if (const UInputMappingContext* OuterContext = Cast<UInputMappingContext>(Parent))
 		{
 			TemplateOuter = OuterContext;
-			TemplateIndex = INDEX_NONE;
 
-			for (int32 Idx = 0; Idx < OuterContext->GetMappings().Num(); Idx++)
+			if (const FST_TemplateLocation* Location = FindTemplateLocation(OuterContext, this))
 			{
-				const FEnhancedActionKeyMapping& RHS = OuterContext->GetMappings()[Idx];
-				const int32 TriggerIndex = RHS.Triggers.IndexOfByKey(this);
-				if (TriggerIndex != INDEX_NONE)
-				{
-					TemplateIndex = TriggerIndex;
-					break;
-				}
+				TemplateMappingIndex = Location->MappingIndex;
+				TemplateIndex = Location->TriggerIndex;
+			}
+			else
+			{
+				UE_LOG(LogST_InputTriggerModifierKeys, Log, TEXT("%s is not referenced by any mapping in %s, saving without a template location"), *GetName(), *OuterContext->GetName());
 			}
-
-			check(TemplateIndex != INDEX_NONE);
 		}
-		else if (const UInputAction* OuterAction = Cast<UInputAction>(GetOuter()))
+		else if (const UInputAction* OuterAction = Cast<UInputAction>(Parent))
 		{
 			TemplateOuter = OuterAction;
-			TemplateIndex = INDEX_NONE;
 		}
-		else
+	}
+}
+
+void UST_InputTriggerModifierKeys::PostLoad()
+{
+	Super::PostLoad();
+
+	RestoreTemplateLink();
+}
+
+void UST_InputTriggerModifierKeys::RestoreTemplateLink()
+{
+	if (!bModifiersAreMappable)
+	{
+		return;
+	}
+
+	// Indices are serialized, the Outer is just whoever owns us.
+	// Runtime copies are owned by the player input, and keep whatever link they were duplicated with.
+	const UObject* Parent = GetOuter();
+	if (const UInputMappingContext* OuterContext = Cast<UInputMappingContext>(Parent))
+	{
+		TemplateOuter = OuterContext;
+
+		// Assets saved before the indices existed load them as INDEX_NONE, and edits since the last save can move us.
+		if (!IsTemplateLocationValid(OuterContext, this, FST_TemplateLocation{ TemplateMappingIndex, TemplateIndex }))
 		{
-			TemplateOuter = nullptr;
-			TemplateIndex = INDEX_NONE;
+			RelocateTemplates(OuterContext);
 		}
 	}
-	else
+	else if (Parent->IsA<UInputAction>())
+	{
+		TemplateOuter = Parent;
+	}
+}
+
+void UST_InputTriggerModifierKeys::RelocateTemplates(const UInputMappingContext* InContext)
+{
+	// One pass fixes every sibling, so the rest of the context's triggers validate in O(1) when they get here.
+	const TArray<FEnhancedActionKeyMapping>& Mappings = InContext->GetMappings();
+	for (int32 MappingIdx = 0; MappingIdx < Mappings.Num(); MappingIdx++)
 	{
-		TemplateOuter = nullptr;
-		TemplateIndex = INDEX_NONE;
+		const FEnhancedActionKeyMapping& Mapping = Mappings[MappingIdx];
+		for (int32 TriggerIdx = 0; TriggerIdx < Mapping.Triggers.Num(); TriggerIdx++)
+		{
+			UST_InputTriggerModifierKeys* ModifierTrigger = Cast<UST_InputTriggerModifierKeys>(Mapping.Triggers[TriggerIdx].Get());
+			if (ModifierTrigger && ModifierTrigger->bModifiersAreMappable)
+			{
+				ModifierTrigger->TemplateOuter = InContext;
+				ModifierTrigger->TemplateMappingIndex = MappingIdx;
+				ModifierTrigger->TemplateIndex = TriggerIdx;
+			}
+		}
 	}
 }
 
 ETriggerState UST_InputTriggerModifierKeys::UpdateState_Implementation(const UEnhancedPlayerInput* PlayerInput, FInputActionValue ModifiedValue, float DeltaTime)
 {
-	// #TODO: Need to check if chorded keys interfere..?
+	// Bound to a dispatch table, only the most-specific mapping for our key may trigger.
+	// The table already holds any player remapped modifiers, and our result can only change on a modifier edge.
+	if (DispatchTable)
+	{
+		const uint32 Serial = DispatchTable->UpdateHeldModifiers(PlayerInput);
+		if (Serial != CachedSerial)
+		{
+			CachedSerial = Serial;
+			CachedState = DispatchTable->FindWinner(DispatchKey, DispatchTable->GetHeldModifiers()) == this ? ETriggerState::Triggered : ETriggerState::None;
+		}
 
-	// #TODO
-	// Read applicable keys from player action mapping. Will need to cache to avoid constant lookups somewhere.
-	const FHT_InputTriggerModifiers CurrentKeys = FHT_InputTriggerModifiers(
-		PlayerInput->IsShiftPressed(),
-		PlayerInput->IsCtrlPressed(),
-		PlayerInput->IsAltPressed(),
-		PlayerInput->IsCmdPressed());
+		return CachedState;
+	}
 
-	const bool bModifiersMatch = RequiredModifierKeys == CurrentKeys;
+	// Unbound (e.g, Action-level triggers) can't be resolved against other mappings.
+	const FST_InputTriggerModifiers CurrentKeys = FST_InputTriggerModifiers::FromKeyState(PlayerInput);
+	const bool bModifiersMatch = RequiredModifierKeys.Matches(CurrentKeys, MatchMode);
 	return bModifiersMatch ? ETriggerState::Triggered : ETriggerState::None;
 }
 
@@ -78,10 +315,24 @@ EDataValidationResult UST_InputTriggerModifierKeys::IsDataValid(TArray<FText>& V
 {
 	EDataValidationResult Result = CombineDataValidationResults(Super::IsDataValid(ValidationErrors), EDataValidationResult::Valid);
 
-	if (!bModifiersAreMappable && !RequiredModifierKeys.HasAnyModifiers())
+	// Mappings sharing our key are only blocked by the dispatch table if they carry a Modifier Keys trigger too.
+	// An empty one is valid (mappable or not), it's how unmodified mappings opt in.
+	const UInputMappingContext* OuterContext = Cast<UInputMappingContext>(GetOuter());
+	if (OuterContext && RequiredModifierKeys.HasAnyModifiers())
 	{
-		ValidationErrors.Add(FText::FromString(FString::Printf(TEXT("Modifier Trigger has no modifiers and is not rebindable"))));
-		Result = EDataValidationResult::Invalid;
+		const TArray<FEnhancedActionKeyMapping>& Mappings = OuterContext->GetMappings();
+		const FEnhancedActionKeyMapping* OwningMapping = Mappings.FindByPredicate([this](const FEnhancedActionKeyMapping& Mapping) { return Mapping.Triggers.Contains(this); });
+
+		for (int32 MappingIdx = 0; OwningMapping && MappingIdx < Mappings.Num(); MappingIdx++)
+		{
+			const FEnhancedActionKeyMapping& Mapping = Mappings[MappingIdx];
+			if (&Mapping != OwningMapping && Mapping.Key == OwningMapping->Key && !Mapping.Triggers.ContainsByPredicate([](const UInputTrigger* Trigger) { return Trigger && Trigger->IsA<UST_InputTriggerModifierKeys>(); }))
+			{
+				ValidationErrors.Add(FText::FromString(FString::Printf(TEXT("Mapping [%i] (%s) has no Modifier Keys trigger, and will fire alongside %s + %s. Add an empty Modifier Keys trigger to it."),
+					MappingIdx, *GetNameSafe(Mapping.Action), *RequiredModifierKeys.ToString(), *Mapping.Key.ToString())));
+				Result = EDataValidationResult::Invalid;
+			}
+		}
 	}
 
 	return Result;
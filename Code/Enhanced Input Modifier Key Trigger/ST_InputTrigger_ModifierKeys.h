@@ -6,35 +6,141 @@
 #include "UObject/ObjectSaveContext.h"
 #include "ST_InputTrigger_ModifierKeys.generated.h"
 
+// Declarations
+class UInputMappingContext;
+struct FST_InputModifierDispatchTable;
+struct FST_InputPlayerMappedModifiers;
+
+/*
+* How held modifiers are compared against the modifiers a mapping requires
+*/
+UENUM()
+enum class EST_InputModifierMatch : uint8
+{
+	/* Every required modifier must be held, others are ignored. Where mappings share a key, the most-specific wins. */
+	AtLeast,
+	/* Held modifiers must match the required modifiers exactly */
+	Exactly
+};
+
+/*
+* Bit index of each modifier within FST_InputTriggerModifiers.
+* Custom slots are assigned in order by UST_InputModifierKeySettings::CustomModifiers.
+*/
+UENUM(BlueprintType, meta = (Bitflags))
+enum class EST_InputModifierSlot : uint8
+{
+	Shift,
+	Ctrl,
+	Alt,
+	Cmd,
+	Custom1,
+	Custom2,
+	Custom3,
+	Custom4,
+	Custom5,
+	Custom6,
+	Custom7,
+	Custom8,
+	Custom9,
+	Custom10,
+	Custom11,
+	Custom12,
+	Custom13,
+	Custom14,
+	Custom15,
+	Custom16,
+	Custom17,
+	Custom18,
+	Custom19,
+	Custom20,
+	Custom21,
+	Custom22,
+	Custom23,
+	Custom24,
+	Custom25,
+	Custom26,
+	Custom27,
+	Custom28,
+	MAX	UMETA(Hidden)
+};
+
+/*
+* Modifier Set
+* A fixed-width bitset of modifiers, one bit per EST_InputModifierSlot.
+*/
 USTRUCT(BlueprintType)
 struct FST_InputTriggerModifiers
 {
 	GENERATED_BODY()
 public:
-	FHT_InputTriggerModifiers() = default;
+	static constexpr int32 MaxModifiers = 32;
+	static_assert(static_cast<int32>(EST_InputModifierSlot::MAX) == MaxModifiers, "Modifier slots must fit the mask");
 
-	explicit FHT_InputTriggerModifiers(const bool bInShift, const bool bInCtrl, const bool bInAlt, const bool bInCmd)
-		: bShift(bInShift)
-		, bCtrl(bInCtrl)
-		, bAlt(bInAlt)
-		, bCmd(bInCmd)
+	// Built-in Modifiers
+	static constexpr uint32 Shift = 1u << static_cast<uint32>(EST_InputModifierSlot::Shift);
+	static constexpr uint32 Ctrl = 1u << static_cast<uint32>(EST_InputModifierSlot::Ctrl);
+	static constexpr uint32 Alt = 1u << static_cast<uint32>(EST_InputModifierSlot::Alt);
+	static constexpr uint32 Cmd = 1u << static_cast<uint32>(EST_InputModifierSlot::Cmd);
+
+	static constexpr uint32 SlotMask(const EST_InputModifierSlot InSlot) { return 1u << static_cast<uint32>(InSlot); }
+
+	constexpr FST_InputTriggerModifiers() = default;
+
+	constexpr explicit FST_InputTriggerModifiers(const uint32 InMask)
+		: Bits(static_cast<int32>(InMask))
 	{}
 
-	bool HasAnyModifiers() const { return bShift || bCtrl || bAlt || bCmd; }
+	constexpr explicit FST_InputTriggerModifiers(const bool bInShift, const bool bInCtrl, const bool bInAlt, const bool bInCmd)
+		: Bits(static_cast<int32>((bInShift ? Shift : 0u) | (bInCtrl ? Ctrl : 0u) | (bInAlt ? Alt : 0u) | (bInCmd ? Cmd : 0u)))
+	{}
 
-	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Input") uint8 bShift : 1;
-	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Input") uint8 bCtrl : 1;
-	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Input") uint8 bAlt : 1;
-	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Input") uint8 bCmd : 1;
+	/* Builds the modifiers currently held by the player, from the keys registered in UST_InputModifierKeySettings. */
+	static FST_InputTriggerModifiers FromKeyState(const UPlayerInput* PlayerInput);
 
-	bool operator==(const FHT_InputTriggerModifiers& RHS) const { return bShift == RHS.bShift && bCtrl == RHS.bCtrl && bAlt == RHS.bAlt && bCmd == RHS.bCmd; }
-	bool operator!=(const FHT_InputTriggerModifiers& RHS) const { return bShift != RHS.bShift || bCtrl != RHS.bCtrl || bAlt != RHS.bAlt || bCmd != RHS.bCmd; }
+	constexpr uint32 GetMask() const { return static_cast<uint32>(Bits); }
+	constexpr bool HasAnyModifiers() const { return Bits != 0; }
+	int32 NumModifiers() const { return static_cast<int32>(FMath::CountBits(GetMask())); }
 
-	FString ToString() const { return FString::Printf(TEXT("Shift [%i] - Ctrl [%i] - Alt [%i] - Cmd [%i]"), bShift, bCtrl, bAlt, bCmd); }
+	/* True if every modifier required here is also held in InHeld. Extra modifiers in InHeld are ignored. */
+	constexpr bool IsSubsetOf(const FST_InputTriggerModifiers& InHeld) const { return (GetMask() & ~InHeld.GetMask()) == 0; }
+	constexpr bool Matches(const FST_InputTriggerModifiers& InHeld, const EST_InputModifierMatch InMatch) const { return InMatch == EST_InputModifierMatch::Exactly ? Bits == InHeld.Bits : IsSubsetOf(InHeld); }
+
+	constexpr bool operator==(const FST_InputTriggerModifiers& RHS) const { return Bits == RHS.Bits; }
+	constexpr bool operator!=(const FST_InputTriggerModifiers& RHS) const { return Bits != RHS.Bits; }
+
+	FString ToString() const;
+
+	void PostSerialize(const FArchive& Ar);
+
+	/* Writable, so Blueprint can build modifiers for UST_InputModifierKeysSubsystem::AddPlayerMappedModifiers() */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Input", meta = (Bitmask, BitmaskEnum = "EST_InputModifierSlot"))
+	int32 Bits = 0;
+
+#if WITH_EDITORONLY_DATA
+	// Fixed Shift/Ctrl/Alt/Cmd bits, folded into Bits on load.
+	UPROPERTY() bool bShift_DEPRECATED = false;
+	UPROPERTY() bool bCtrl_DEPRECATED = false;
+	UPROPERTY() bool bAlt_DEPRECATED = false;
+	UPROPERTY() bool bCmd_DEPRECATED = false;
+#endif
+};
+
+template<>
+struct TStructOpsTypeTraits<FST_InputTriggerModifiers> : public TStructOpsTypeTraitsBase2<FST_InputTriggerModifiers>
+{
+	enum
+	{
+		WithPostSerialize = true
+	};
 };
 
 /*
 * Allows modifier keys to modify trigger state
+* 
+* Mappings sharing a key are resolved through the owning player's dispatch table (see UST_InputModifierKeysSubsystem).
+* Only the most-specific mapping whose required modifiers are held will trigger, so Ctrl+S consumes S.
+* The unmodified mapping must also carry this trigger (with no modifiers) for the table to block it.
 */
 UCLASS(NotBlueprintable, MinimalAPI, meta = (DisplayName = "Modifier Keys"))
 class UST_InputTriggerModifierKeys final : public UInputTrigger
@@ -45,12 +151,19 @@ public:
 	UST_InputTriggerModifierKeys(const FObjectInitializer& OI);
 
 	// UObject Interface
+	virtual void Serialize(FArchive& Ar) override;
 	virtual void PreSave(FObjectPreSaveContext SaveContext) override;
+	virtual void PostLoad() override;
 
 #if WITH_EDITOR
 	virtual EDataValidationResult IsDataValid(TArray<FText>& ValidationErrors) override;
 #endif
 
+	// Accessors
+	const FST_InputTriggerModifiers& GetRequiredModifierKeys() const { return RequiredModifierKeys; }
+	void SetRequiredModifierKeys(const FST_InputTriggerModifiers& InModifiers) { RequiredModifierKeys = InModifiers; }
+	EST_InputModifierMatch GetMatchMode() const { return MatchMode; }
+
 	// UInputTrigger Interface
 public:
 	virtual ETriggerEventsSupported GetSupportedTriggerEvents() const override { return ETriggerEventsSupported::Instant; }
@@ -61,19 +174,43 @@ protected:
 
 	/** Modifiers keys required to trigger action */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Input", meta = (ShowOnlyInnerProperties))
-	FHT_InputTriggerModifiers RequiredModifierKeys = {};
+	FST_InputTriggerModifiers RequiredModifierKeys = {};
+
+	/** Whether other held modifiers prevent the action from triggering. Triggers saved before this existed load as Exactly. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Input")
+	EST_InputModifierMatch MatchMode = EST_InputModifierMatch::AtLeast;
 
 	/*
-	* If true, modifier keys can be remapped by the user.
+	* If true, modifier keys can be remapped by the user (see UST_InputModifierKeysSubsystem::AddPlayerMappedModifiers).
 	* If false, modifier keys are locked to whatever is set here.
 	*/
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Input", meta = (ShowOnlyInnerProperties))
 	bool bModifiersAreMappable = true;
 
 	/*
-	* Parent Context/Action. Serialized so we can link to action/context key remap settings
-	* #TODO: Make Transient, and restore from PostLoad()?
+	* Parent Context/Action, so we can link to action/context key remap settings.
+	* Restored from the Outer in PostLoad(). Runtime copies are made with DuplicateObject, which skips transient properties,
+	* so Serialize() copies it across by hand.
 	*/
-	UPROPERTY(VisibleDefaultsOnly, Category = "Input", meta = (DisplayThumbnail = "false")) TSoftObjectPtr<const UObject> TemplateOuter;
-	UPROPERTY(VisibleDefaultsOnly, Category = "Input") int32 TemplateIndex;
+	UPROPERTY(Transient, VisibleDefaultsOnly, Category = "Input") TWeakObjectPtr<const UObject> TemplateOuter;
+
+	/* Index of the owning mapping within TemplateOuter, and of this trigger within that mapping. */
+	UPROPERTY(VisibleDefaultsOnly, Category = "Input") int32 TemplateMappingIndex = INDEX_NONE;
+	UPROPERTY(VisibleDefaultsOnly, Category = "Input") int32 TemplateIndex = INDEX_NONE;
+
+private:
+	/* Points TemplateOuter at our Outer, and relocates us within it if the serialized indices are missing or stale */
+	void RestoreTemplateLink();
+	static void RelocateTemplates(const UInputMappingContext* InContext);
+
+	friend FST_InputModifierDispatchTable;
+	friend FST_InputPlayerMappedModifiers;
+
+	/* Runtime only. Table this instance was bound to when the player's mapping contexts were applied. */
+	const FST_InputModifierDispatchTable* DispatchTable = nullptr;
+	FKey DispatchKey;
+
+	/* Last result while bound, valid until the table's serial changes. */
+	uint32 CachedSerial = 0;
+	ETriggerState CachedState = ETriggerState::None;
 };
\ No newline at end of file
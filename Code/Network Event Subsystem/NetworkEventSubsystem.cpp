@@ -2,8 +2,11 @@
 #include "GameFramework/GameStateBase.h"
 #include "GameFramework/PlayerState.h"
 #include "Engine/LocalPlayer.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/LowLevelMemTracker.h"
 
 DEFINE_LOG_CATEGORY_STATIC(LogNetworkEventSubsystem, Log, All);
+LLM_DEFINE_TAG(NetworkEventSubsystem);
 
 ///////////////////////
 ///// Constructor /////
@@ -13,6 +16,10 @@ UNetworkEventSubsystem::UNetworkEventSubsystem()
 	: Super()
 {
 	bNetworkGameReady = false;
+
+	NumRegistrations = 0;
+	NumReleases = 0;
+	PeakDelegateBytes = 0;
 }
 
 //////////////////////////
@@ -21,6 +28,7 @@ UNetworkEventSubsystem::UNetworkEventSubsystem()
 
 void UNetworkEventSubsystem::Initialize(FSubsystemCollectionBase& Collection)
 {
+	LLM_SCOPE_BYTAG(NetworkEventSubsystem);
 	Super::Initialize(Collection);
 
 	ConditionalBroadcastNetworkGameReady();
@@ -65,7 +73,13 @@ FDelegateHandle UNetworkEventSubsystem::CallAndRegister_OnNetworkGameReady(const
 			UNetworkEventSubsystem* NES = lWorld->GetSubsystem<UNetworkEventSubsystem>();
 			if (NES)
 			{
-				FDelegateHandle ReturnVal = NES->OnNetworkGameReady.Add(Callback);
+				FDelegateHandle ReturnVal;
+				{
+					LLM_SCOPE_BYTAG(NetworkEventSubsystem);
+					ReturnVal = NES->OnNetworkGameReady.Add(Callback);
+					NES->RecordListenerRegistration();
+				}
+
 				if (NES->IsNetworkGameReady())
 				{
 					Callback.Execute();
@@ -89,7 +103,12 @@ FDelegateHandle UNetworkEventSubsystem::CallAndRegister_OnPlayersUpdated(const U
 			UNetworkEventSubsystem* NES = lWorld->GetSubsystem<UNetworkEventSubsystem>();
 			if (NES)
 			{
-				FDelegateHandle ReturnVal = NES->OnPlayersUpdated.Add(Callback);
+				FDelegateHandle ReturnVal;
+				{
+					LLM_SCOPE_BYTAG(NetworkEventSubsystem);
+					ReturnVal = NES->OnPlayersUpdated.Add(Callback);
+					NES->RecordListenerRegistration();
+				}
 
 				AGameStateBase* WorldGS = lWorld->GetGameState();
 				if (IsValid(WorldGS))
@@ -107,8 +126,9 @@ FDelegateHandle UNetworkEventSubsystem::CallAndRegister_OnPlayersUpdated(const U
 
 void UNetworkEventSubsystem::ReleaseAll(const void* InObject)
 {
-	OnNetworkGameReady.RemoveAll(InObject);
-	OnPlayersUpdated.RemoveAll(InObject);
+	// Count listeners actually removed, so Registrations vs Releases shows leaks rather than calls.
+	NumReleases += OnNetworkGameReady.RemoveAll(InObject);
+	NumReleases += OnPlayersUpdated.RemoveAll(InObject);
 }
 
 //////////////////////////////////
@@ -182,4 +202,48 @@ void UNetworkEventSubsystem::NotifyPlayerArrayUpdated()
 bool UNetworkEventSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
 {
 	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
-}
\ No newline at end of file
+}
+
+///////////////////////////////
+///// Listener Accounting /////
+///////////////////////////////
+
+void UNetworkEventSubsystem::RecordListenerRegistration()
+{
+	NumRegistrations++;
+	PeakDelegateBytes = FMath::Max(PeakDelegateBytes, GetDelegateAllocatedSize());
+}
+
+SIZE_T UNetworkEventSubsystem::GetDelegateAllocatedSize() const
+{
+	return OnNetworkGameReady.GetAllocatedSize() + OnPlayersUpdated.GetAllocatedSize() + OnPlayersUpdatedDynamic.GetAllocatedSize();
+}
+
+void UNetworkEventSubsystem::DumpListenerStats(FOutputDevice& Ar) const
+{
+	const UWorld* lWorld = GetWorld();
+	Ar.Logf(TEXT("%-48s Registrations [%i] - Releases [%i] - Listeners [%i] - Delegates Live [%llu B] - Peak [%llu B]"),
+		lWorld ? *lWorld->GetOutermost()->GetName() : TEXT("None"),
+		NumRegistrations,
+		NumReleases,
+		NumRegistrations - NumReleases,
+		(uint64)GetDelegateAllocatedSize(),
+		(uint64)FMath::Max(PeakDelegateBytes, GetDelegateAllocatedSize()));
+}
+
+static void DumpNetworkEventListeners(FOutputDevice& Ar)
+{
+	for (const FWorldContext& WorldContext : GEngine->GetWorldContexts())
+	{
+		const UWorld* lWorld = WorldContext.World();
+		if (const UNetworkEventSubsystem* NES = lWorld ? lWorld->GetSubsystem<UNetworkEventSubsystem>() : nullptr)
+		{
+			NES->DumpListenerStats(Ar);
+		}
+	}
+}
+
+static FAutoConsoleCommandWithOutputDevice DumpNetworkEventListenersCmd(
+	TEXT("NetworkEvents.ListenerReport"),
+	TEXT("Lists listener registrations and delegate storage of the Network Event Subsystem, per world."),
+	FConsoleCommandWithOutputDeviceDelegate::CreateStatic(&DumpNetworkEventListeners));
@@ -39,6 +39,9 @@ public:
 
 	void ReleaseAll(const void* InObject);
 
+	/* Listener registrations and delegate storage for this world. See 'NetworkEvents.ListenerReport'. */
+	void DumpListenerStats(FOutputDevice& Ar) const;
+
 	// Accessors
 	void NotifyGameNetworkActorUpdate() { ConditionalBroadcastNetworkGameReady(); }
 	void NotifyPlayerArrayUpdated();
@@ -59,8 +62,16 @@ private:
 	void ConditionalBroadcastNetworkGameReady();
 	bool CheckNetworkGameReady() const;
 
+	void RecordListenerRegistration();
+	SIZE_T GetDelegateAllocatedSize() const;
+
 	FOnNetworkGameReady OnNetworkGameReady;
 	FOnGameStateEvent OnPlayersUpdated;
 
 	bool bNetworkGameReady;
+
+	// Listener Accounting. Releases counts listeners removed by ReleaseAll(), not calls to it.
+	int32 NumRegistrations;
+	int32 NumReleases;
+	SIZE_T PeakDelegateBytes;
 };
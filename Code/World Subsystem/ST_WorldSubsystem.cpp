@@ -1,16 +1,47 @@
 // Copyright (c) James Baxter. All Rights Reserved.
 
 #include "ST_WorldSubsystem.h"
+#include "ST_WorldSubsystemParallelTick.h"
 
 // Engine
 #include "Engine/World.h"
 #include "GameMapsSettings.h"
+#include "Engine/Engine.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/PackageName.h"
 
 #if WITH_EDITOR
 #include "Editor.h"
 #include "Engine/NetDriver.h"
 #endif
 
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+#define ST_WORLDSUBSYSTEM_LLM_SCOPE(Subsystem) FLLMScope SubsystemLLMScope((Subsystem)->GetLLMTagName(), false, ELLMTagSet::None, ELLMTracker::Default)
+
+namespace
+{
+	/* Every tag handed out, so the report can find memory still held after a subsystem is gone. Game Thread only. */
+	TSet<FName> GST_WorldSubsystemLLMTags;
+
+	/* Index of the world's context, stable across map changes, unlike the world itself */
+	int32 GetWorldContextSlot(const UWorld* InWorld)
+	{
+		const TIndirectArray<FWorldContext>& WorldContexts = GEngine->GetWorldContexts();
+		for (int32 ContextIdx = 0; ContextIdx < WorldContexts.Num(); ContextIdx++)
+		{
+			if (WorldContexts[ContextIdx].World() == InWorld)
+			{
+				return ContextIdx;
+			}
+		}
+
+		return INDEX_NONE;
+	}
+}
+#else
+#define ST_WORLDSUBSYSTEM_LLM_SCOPE(Subsystem)
+#endif
+
 /////////////////////////
 ///// Tick Function /////
 /////////////////////////
@@ -18,7 +49,7 @@
 void FST_WorldSubsystemTickFunction::ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
 {
 	check(Target);
-	Target->TickSubsystem(DeltaTime);
+	Target->ExecuteSubsystemTick(DeltaTime);
 }
 
 FString FST_WorldSubsystemTickFunction::DiagnosticMessage()
@@ -50,6 +81,8 @@ UST_WorldSubsystem::UST_WorldSubsystem()
 
 	bEnableInUntitledLevel = false;
 	bEnableInTransitionLevel = false;
+	bWorldIsolatedTick = false;
+	bRegisteredWithParallelTickHost = false;
 
 	// Initialise in all network domains by default
 	InitialisationNetModeMask |= (uint8)1 << static_cast<uint8>(ENetMode::NM_Standalone);
@@ -96,11 +129,20 @@ bool UST_WorldSubsystem::ShouldCreateSubsystem(UObject* InOuter) const
 
 void UST_WorldSubsystem::Initialize(FSubsystemCollectionBase& Collection)
 {
-	Super::Initialize(Collection);
-
 	const UWorld* lWorld = GetWorld();
 	check(lWorld && lWorld->IsGameWorld() && lWorld->PersistentLevel != nullptr);
 
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+	// LLM never frees tags, so they must be stable across map changes. Short map name (tags are '/' separated, so no
+	// package path), plus the world context slot since instances of the same map share a package name.
+	const int32 ContextSlot = GetWorldContextSlot(lWorld);
+	LLMTagName = FName(*FString::Printf(TEXT("ST_WorldSubsystems/%s/%s_%i"), *GetClass()->GetName(), *FPackageName::GetShortName(lWorld->GetOutermost()), ContextSlot));
+	GST_WorldSubsystemLLMTags.Add(LLMTagName);
+#endif
+	ST_WORLDSUBSYSTEM_LLM_SCOPE(this);
+
+	Super::Initialize(Collection);
+
 	// Can't actually do safe initialisation until much later...
 	PostInitWorldDelegateHandle = FCoreUObjectDelegates::PostLoadMapWithWorld.AddUObject(this, &UST_WorldSubsystem::PostInitWorldInternal);
 
@@ -108,11 +150,19 @@ void UST_WorldSubsystem::Initialize(FSubsystemCollectionBase& Collection)
 	// Editor environment is added fun
 	PostInitWorldPIEDelegateHandle = FEditorDelegates::PostPIEStarted.AddUObject(this, &UST_WorldSubsystem::PostInitWorldPIEInternal);
 #endif
+
+	InitializeSubsystem(Collection);
 }
 
 void UST_WorldSubsystem::Deinitialize()
 {
 	SubsystemTickFunction.UnRegisterTickFunction();
+	if (bRegisteredWithParallelTickHost)
+	{
+		FST_WorldSubsystemParallelTickHost::Get().Unregister(this);
+		bRegisteredWithParallelTickHost = false;
+	}
+
 	FCoreUObjectDelegates::PostLoadMapWithWorld.Remove(PostInitWorldDelegateHandle);
 #if WITH_EDITOR
 	FEditorDelegates::PostPIEStarted.Remove(PostInitWorldPIEDelegateHandle);
@@ -143,13 +193,30 @@ void UST_WorldSubsystem::PostInitWorldInternal(UWorld* NewWorld)
 		{
 			SubsystemTickFunction.Target = this;
 			SubsystemTickFunction.SetTickFunctionEnable(SubsystemTickFunction.bStartWithTickEnabled || SubsystemTickFunction.IsTickFunctionEnabled());
-			SubsystemTickFunction.RegisterTickFunction(lWorld->PersistentLevel);
+
+			// In host mode, world-isolated subsystems are ticked by the host rather than their world.
+			if (bWorldIsolatedTick && FST_WorldSubsystemParallelTickHost::IsEnabled())
+			{
+				FST_WorldSubsystemParallelTickHost::Get().Register(this);
+				bRegisteredWithParallelTickHost = true;
+			}
+			else
+			{
+				SubsystemTickFunction.RegisterTickFunction(lWorld->PersistentLevel);
+			}
 		}
 
+		ST_WORLDSUBSYSTEM_LLM_SCOPE(this);
 		OnWorldInitialized();
 	}
 }
 
+void UST_WorldSubsystem::ExecuteSubsystemTick(const float InDeltaTime)
+{
+	ST_WORLDSUBSYSTEM_LLM_SCOPE(this);
+	TickSubsystem(InDeltaTime);
+}
+
 #if WITH_EDITOR
 void UST_WorldSubsystem::PostInitWorldPIEInternal(bool bSimulating)
 {
@@ -215,10 +282,16 @@ bool UST_WorldSubsystem::CheckLevelName(const UWorld* lWorld) const
 ///// Utilities /////
 /////////////////////
 
+bool UST_WorldSubsystem::IsInParallelWorldTick()
+{
+	return FST_WorldSubsystemParallelTickHost::IsInParallelWorldTick();
+}
+
 bool UST_WorldSubsystem::GetSafeNetMode(ENetMode& OutMode, const UWorld* OverrideWorld /*= nullptr*/) const
 {
 	const UWorld* lWorld = OverrideWorld ? OverrideWorld : GetWorld();
 	check(lWorld);
+	ST_CHECK_PARALLEL_WORLD_ACCESS(lWorld);
 
 	OutMode = lWorld->GetNetMode();
 
@@ -227,6 +300,8 @@ bool UST_WorldSubsystem::GetSafeNetMode(ENetMode& OutMode, const UWorld* Overrid
 	// See https://udn.unrealengine.com/s/question/0D54z00007DW1CQCA1/why-are-uworldsubsystems-initialized-before-uworld-is-initialized
 	if (lWorld->IsPlayInEditor())
 	{
+		ST_CHECK_NOT_IN_PARALLEL_WORLD_TICK();
+
 		UEditorEngine* const EditorEngine = CastChecked<UEditorEngine>(GEngine);
 		const UPackage* Package = Cast<UPackage>(lWorld->GetOuter());
 		if (!Package || Package->GetPIEInstanceID() == INDEX_NONE)
@@ -255,4 +330,66 @@ bool UST_WorldSubsystem::GetSafeNetMode(ENetMode& OutMode, const UWorld* Overrid
 #endif
 
 	return true;
-}
\ No newline at end of file
+}
+
+/////////////////////////
+///// Memory Report /////
+/////////////////////////
+
+static void DumpWorldSubsystemMemory(FOutputDevice& Ar)
+{
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+	if (!FLowLevelMemTracker::IsEnabled())
+	{
+		Ar.Logf(TEXT("LLM is disabled. Run with -llm to track World Subsystem memory."));
+		return;
+	}
+
+	ST_CHECK_NOT_IN_PARALLEL_WORLD_TICK();
+
+	Ar.Logf(TEXT("%-48s %-48s %12s %12s"), TEXT("Subsystem"), TEXT("Tag"), TEXT("Live (KB)"), TEXT("Peak (KB)"));
+
+	int64 TotalLive = 0;
+	TSet<FName> LiveTags;
+	for (const FWorldContext& WorldContext : GEngine->GetWorldContexts())
+	{
+		const UWorld* lWorld = WorldContext.World();
+		if (!lWorld)
+		{
+			continue;
+		}
+
+		for (const UST_WorldSubsystem* Subsystem : lWorld->GetSubsystemArray<UST_WorldSubsystem>())
+		{
+			const int64 LiveBytes = FLowLevelMemTracker::Get().GetTagAmountForTracker(ELLMTracker::Default, Subsystem->GetLLMTagName(), ELLMTagSet::None, false);
+			const int64 PeakBytes = FLowLevelMemTracker::Get().GetTagAmountForTracker(ELLMTracker::Default, Subsystem->GetLLMTagName(), ELLMTagSet::None, true);
+			TotalLive += LiveBytes;
+			LiveTags.Add(Subsystem->GetLLMTagName());
+
+			Ar.Logf(TEXT("%-48s %-48s %12.1f %12.1f"), *Subsystem->GetClass()->GetName(), *Subsystem->GetLLMTagName().ToString(), LiveBytes / 1024.0, PeakBytes / 1024.0);
+		}
+	}
+
+	// Memory left behind by subsystems that no longer exist, i.e leaks across world teardown.
+	for (const FName& Tag : GST_WorldSubsystemLLMTags)
+	{
+		if (!LiveTags.Contains(Tag))
+		{
+			const int64 LiveBytes = FLowLevelMemTracker::Get().GetTagAmountForTracker(ELLMTracker::Default, Tag, ELLMTagSet::None, false);
+			const int64 PeakBytes = FLowLevelMemTracker::Get().GetTagAmountForTracker(ELLMTracker::Default, Tag, ELLMTagSet::None, true);
+			TotalLive += LiveBytes;
+
+			Ar.Logf(TEXT("%-48s %-48s %12.1f %12.1f"), TEXT("(No Live Subsystem)"), *Tag.ToString(), LiveBytes / 1024.0, PeakBytes / 1024.0);
+		}
+	}
+
+	Ar.Logf(TEXT("Total Live: %.1f KB"), TotalLive / 1024.0);
+#else
+	Ar.Logf(TEXT("LLM is not compiled into this build."));
+#endif
+}
+
+static FAutoConsoleCommandWithOutputDevice DumpWorldSubsystemMemoryCmd(
+	TEXT("ST.WorldSubsystems.MemReport"),
+	TEXT("Lists live and peak LLM bytes for each ST World Subsystem, per world. Requires -llm."),
+	FConsoleCommandWithOutputDeviceDelegate::CreateStatic(&DumpWorldSubsystemMemory));
@@ -4,10 +4,12 @@
 
 #include "Subsystems/WorldSubsystem.h"
 #include "Engine/EngineBaseTypes.h"
+#include "HAL/LowLevelMemTracker.h"
 #include "ST_WorldSubsystem.generated.h"
 
 // Declarations
 class UST_WorldSubsystem;
+class FST_WorldSubsystemParallelTickHost;
 
 /*
 * World Subsystem Tick Function
@@ -48,15 +50,27 @@ public:
 	UST_WorldSubsystem();
 
 	virtual bool ShouldCreateSubsystem(UObject* InOuter) const override;
-	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override final;
 	virtual void Deinitialize() override;
 
 	bool GetSafeNetMode(ENetMode& OutMode, const UWorld* OverrideWorld = nullptr) const;
 
+	/* True while ticking world-isolated subsystems on a worker thread. See ST_CHECK_NOT_IN_PARALLEL_WORLD_TICK. */
+	static bool IsInParallelWorldTick();
+
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+	/* LLM tag covering this subsystems Initialize, OnWorldInitialized and Tick. Unique per class, map and world context. */
+	FName GetLLMTagName() const { return LLMTagName; }
+#endif
+
 protected:
 	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
 
 	friend FST_WorldSubsystemTickFunction;
+	friend FST_WorldSubsystemParallelTickHost;
+
+	/* Virtual stub for child class initialisation, in place of Initialize() so allocations are attributed to the subsystem. */
+	virtual void InitializeSubsystem(FSubsystemCollectionBase& Collection) {}
 
 	/* Virtual stub that can be overridden in a child class to perform safer initialisation. */
 	virtual void OnWorldInitialized() {}
@@ -89,11 +103,26 @@ protected:
 	UPROPERTY(EditDefaultsOnly, Category = "Subsystem Tick")
 	FST_WorldSubsystemTickFunction SubsystemTickFunction;
 
+	/*
+	* If true, the tick only touches this subsystems own world and never global state.
+	* With 'ST.WorldSubsystems.ParallelWorldTick' enabled, it ticks on a worker thread alongside other worlds instead.
+	* That tick runs outside of the world's own tick, so TickGroup no longer places it relative to physics or actors.
+	* Development builds assert on other worlds reached through ST_CHECK_PARALLEL_WORLD_ACCESS.
+	*/
+	UPROPERTY(EditDefaultsOnly, Category = "Subsystem Tick", AdvancedDisplay)
+	uint8 bWorldIsolatedTick : 1;
+
 private:
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+	FName LLMTagName;
+#endif
+
 	FDelegateHandle PostInitWorldDelegateHandle;
 	bool bHasPostWorldInitialized;
+	bool bRegisteredWithParallelTickHost;
 
 	void PostInitWorldInternal(UWorld* NewWorld);
+	void ExecuteSubsystemTick(const float InDeltaTime);
 
 #if WITH_EDITOR
 	FDelegateHandle PostInitWorldPIEDelegateHandle;
@@ -0,0 +1,144 @@
+// Copyright (c) James Baxter. All Rights Reserved.
+
+#include "ST_WorldSubsystemParallelTick.h"
+#include "ST_WorldSubsystem.h"
+
+// Engine
+#include "Async/ParallelFor.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+namespace
+{
+	int32 GST_ParallelWorldTick = 0;
+	FAutoConsoleVariableRef CVarParallelWorldTick(
+		TEXT("ST.WorldSubsystems.ParallelWorldTick"),
+		GST_ParallelWorldTick,
+		TEXT("If enabled, world-isolated ST World Subsystems tick in parallel across worlds on worker threads.\n")
+		TEXT("Only applies to subsystems initialized after it is set, so set it from config or the command line."),
+		ECVF_Default);
+
+	/* World the current task is ticking, null outside of host mode tasks */
+	thread_local const UWorld* GST_ParallelTickWorld = nullptr;
+}
+
+////////////////////
+///// Accessor /////
+////////////////////
+
+bool FST_WorldSubsystemParallelTickHost::IsEnabled()
+{
+	return GST_ParallelWorldTick != 0;
+}
+
+bool FST_WorldSubsystemParallelTickHost::IsInParallelWorldTick()
+{
+	return GST_ParallelTickWorld != nullptr;
+}
+
+bool FST_WorldSubsystemParallelTickHost::IsWorldAccessAllowed(const UWorld* InWorld)
+{
+	return GST_ParallelTickWorld == nullptr || GST_ParallelTickWorld == InWorld;
+}
+
+FST_WorldSubsystemParallelTickHost& FST_WorldSubsystemParallelTickHost::Get()
+{
+	static FST_WorldSubsystemParallelTickHost Host;
+	return Host;
+}
+
+////////////////////////
+///// Registration /////
+////////////////////////
+
+void FST_WorldSubsystemParallelTickHost::Register(UST_WorldSubsystem* InSubsystem)
+{
+	check(IsInGameThread());
+	ST_CHECK_NOT_IN_PARALLEL_WORLD_TICK();
+	check(InSubsystem);
+
+	UWorld* lWorld = InSubsystem->GetWorld();
+	check(lWorld);
+
+	TUniquePtr<FWorldEntry>* ExistingEntry = Worlds.FindByPredicate([lWorld](const TUniquePtr<FWorldEntry>& Entry) { return Entry->World.Get() == lWorld; });
+	FWorldEntry& WorldEntry = ExistingEntry ? **ExistingEntry : *Worlds.Add_GetRef(MakeUnique<FWorldEntry>());
+	WorldEntry.World = lWorld;
+	WorldEntry.Subsystems.AddUnique(InSubsystem);
+
+	if (!TickerHandle.IsValid())
+	{
+		TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FST_WorldSubsystemParallelTickHost::Tick));
+	}
+}
+
+void FST_WorldSubsystemParallelTickHost::Unregister(UST_WorldSubsystem* InSubsystem)
+{
+	check(IsInGameThread());
+	ST_CHECK_NOT_IN_PARALLEL_WORLD_TICK();
+
+	for (int32 WorldIdx = Worlds.Num() - 1; WorldIdx >= 0; WorldIdx--)
+	{
+		Worlds[WorldIdx]->Subsystems.Remove(InSubsystem);
+		if (Worlds[WorldIdx]->Subsystems.Num() == 0)
+		{
+			Worlds.RemoveAt(WorldIdx);
+		}
+	}
+
+	if (Worlds.Num() == 0 && TickerHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+		TickerHandle.Reset();
+	}
+}
+
+////////////////
+///// Tick /////
+////////////////
+
+bool FST_WorldSubsystemParallelTickHost::Tick(float DeltaTime)
+{
+	check(IsInGameThread());
+
+	TArray<FTickableWorld, TInlineAllocator<16>> TickableWorlds;
+	for (const TUniquePtr<FWorldEntry>& Entry : Worlds)
+	{
+		const UWorld* lWorld = Entry->World.Get();
+		if (lWorld && !lWorld->bIsTearingDown)
+		{
+			// Worlds tick one after another on the Game Thread, so none should be mid-tick when we run.
+			checkf(!lWorld->bInTick, TEXT("Parallel World Tick is running inside the tick of %s"), *lWorld->GetName());
+			TickableWorlds.Add({ Entry.Get(), lWorld, lWorld->GetDeltaSeconds(), lWorld->IsPaused(), lWorld->IsNetMode(NM_DedicatedServer) });
+		}
+	}
+
+	// Each group is a sync point, every world finishes it before any world starts the next.
+	for (uint8 Group = TG_PrePhysics; Group < TG_NewlySpawned; Group++)
+	{
+		ParallelFor(TickableWorlds.Num(), [&TickableWorlds, Group, this](int32 WorldIdx)
+		{
+			TickWorldGroup(TickableWorlds[WorldIdx], static_cast<ETickingGroup>(Group));
+		});
+	}
+
+	return true;
+}
+
+void FST_WorldSubsystemParallelTickHost::TickWorldGroup(const FTickableWorld& InWorld, const ETickingGroup InGroup)
+{
+	// Anything reached from here with ST_CHECK_PARALLEL_WORLD_ACCESS must belong to this world.
+	TGuardValue<const UWorld*> ParallelTickGuard(GST_ParallelTickWorld, InWorld.World);
+
+	for (UST_WorldSubsystem* Subsystem : InWorld.Entry->Subsystems)
+	{
+		ST_CHECK_PARALLEL_WORLD_ACCESS(Subsystem->GetWorld());
+
+		const FST_WorldSubsystemTickFunction& TickFunction = Subsystem->SubsystemTickFunction;
+		if (TickFunction.TickGroup == InGroup && TickFunction.IsTickFunctionEnabled()
+			&& (!InWorld.bPaused || TickFunction.bTickEvenWhenPaused)
+			&& (!InWorld.bDedicatedServer || TickFunction.bAllowTickOnDedicatedServer))
+		{
+			Subsystem->ExecuteSubsystemTick(InWorld.DeltaTime);
+		}
+	}
+}
@@ -0,0 +1,73 @@
+// Copyright (c) James Baxter. All Rights Reserved.
+
+#pragma once
+
+#include "Containers/Ticker.h"
+#include "Engine/EngineBaseTypes.h"
+#include "UObject/WeakObjectPtrTemplates.h"
+
+// Declarations
+class UST_WorldSubsystem;
+class UWorld;
+
+/*
+* Parallel World Tick Host
+* Opt-in host mode for processes running several independent worlds ('ST.WorldSubsystems.ParallelWorldTick 1').
+*
+* Subsystems flagged with bWorldIsolatedTick are removed from their world's tick and ticked here once per frame instead.
+* Each tick group runs as one task per world, and must complete across all worlds before the next group begins.
+* A world's own subsystems still tick serially, in registration order.
+* Pause (bTickEvenWhenPaused) and bAllowTickOnDedicatedServer are honoured, TickInterval is not supported in host mode.
+*
+* The host ticks from the core ticker, outside of any world's tick. Tick groups only order host-mode subsystems against
+* each other, not against physics or actors in their world (e.g, TG_PostPhysics does not see this frame's physics).
+*/
+class FST_WorldSubsystemParallelTickHost
+{
+public:
+	static bool IsEnabled();
+	static bool IsInParallelWorldTick();
+	static FST_WorldSubsystemParallelTickHost& Get();
+
+	/* False if called from a world task for any world other than InWorld, see ST_CHECK_PARALLEL_WORLD_ACCESS. */
+	static bool IsWorldAccessAllowed(const UWorld* InWorld);
+
+	void Register(UST_WorldSubsystem* InSubsystem);
+	void Unregister(UST_WorldSubsystem* InSubsystem);
+
+private:
+	struct FWorldEntry
+	{
+		TWeakObjectPtr<UWorld> World;
+		TArray<UST_WorldSubsystem*> Subsystems;
+	};
+
+	/* World state resolved on the Game Thread, so tasks don't need to touch the UWorld */
+	struct FTickableWorld
+	{
+		FWorldEntry* Entry;
+		const UWorld* World;
+		float DeltaTime;
+		bool bPaused;
+		bool bDedicatedServer;
+	};
+
+	bool Tick(float DeltaTime);
+	void TickWorldGroup(const FTickableWorld& InWorld, const ETickingGroup InGroup);
+
+	// Heap allocated, tasks hold entries while the Game Thread may register more
+	TArray<TUniquePtr<FWorldEntry>> Worlds;
+	FTSTicker::FDelegateHandle TickerHandle;
+};
+
+/*
+* Asserts that world-isolated ticks only touch their own world. Use wherever a world (or something owned by one) is
+* accessed from code that may run in host mode, e.g before reaching into another subsystem.
+*/
+#if DO_CHECK
+#define ST_CHECK_PARALLEL_WORLD_ACCESS(World) checkf(FST_WorldSubsystemParallelTickHost::IsWorldAccessAllowed(World), TEXT("World-isolated tick accessed another world (%s)"), *GetNameSafe(World))
+#define ST_CHECK_NOT_IN_PARALLEL_WORLD_TICK() checkf(!FST_WorldSubsystemParallelTickHost::IsInParallelWorldTick(), TEXT("Global state accessed from a world-isolated tick"))
+#else
+#define ST_CHECK_PARALLEL_WORLD_ACCESS(World)
+#define ST_CHECK_NOT_IN_PARALLEL_WORLD_TICK()
+#endif